@@ -22,8 +22,39 @@ extern "C" {
 // New: index marker emitted inside a composite utterance stream.
 #define BL_ITEM_INDEX 4
 
+// Overflow policy when the reader falls more than the buffer limit behind.
+// BLOCK (default): hold the engine inside waveOutWrite until the reader has
+//                  drained half the buffer (or freed queue slots, if those
+//                  ran out first); bl_stop() releases it at once. Nothing
+//                  is dropped.
+// DROP:            discard the oldest queued audio (never INDEX/DONE markers).
+#define BL_OVERFLOW_DROP  0
+#define BL_OVERFLOW_BLOCK 1
+
+// How hook_waveOutWrite paces the engine.
+// LOOKAHEAD (default): run flat out until the lookahead (300 ms) of audio is
+//                      queued, then keep pace with the reader (it waits on
+//                      consumption).
+// REALTIME:            sleep each buffer's duration after the burst credit
+//                      (200 ms), whatever the reader is doing (the original
+//                      behavior).
+// Both budgets are adjustable with bl_setLookaheadMs().
+#define BL_PACING_REALTIME  0
+#define BL_PACING_LOOKAHEAD 1
+
 typedef struct BL_STATE BL_STATE;
 
+// One entry filled in by bl_readMany().
+// - type/value: as returned by bl_read() (for audio, value == audioLen).
+// - audioOffset/audioLen: where this item's PCM sits in the caller's audio
+//   buffer (audioLen is 0 for markers).
+typedef struct BL_READ_ITEM {
+	int type;
+	int value;
+	int audioOffset;
+	int audioLen;
+} BL_READ_ITEM;
+
 // Initialize wrapper. Returns a state pointer or NULL on failure.
 // - ttsDllPath: absolute or relative path to the Brailab speech DLL.
 // - initValue: wrapper/engine-specific init parameter (kept for backward compatibility).
@@ -32,13 +63,84 @@ BL_API BL_STATE* __cdecl bl_initW(const wchar_t* ttsDllPath, int initValue);
 // Free wrapper state.
 BL_API void __cdecl bl_free(BL_STATE* s);
 
-// Stop the current speech stream and clear pending output.
+// What this build does beyond the original API, so a driver can tell it from
+// an older brailab_wrapper.dll (which lacks this export). Bits:
+// CHUNKING: bl_startSpeakW() and bl_addTextUtteranceW() take text of any
+//           length; older builds need it cut to 450 characters by the caller.
+#define BL_FEATURE_CHUNKING 1
+
+BL_API int __cdecl bl_getFeatures(void);
+
+// Stop the current speech stream and discard pending output.
+// O(1): queued items are invalidated, not freed; reads never return them.
 BL_API void __cdecl bl_stop(BL_STATE* s);
 
 // Legacy API: speak one chunk (one wrapper "utterance").
 // - noIntonation: engine-specific flag (kept as-is).
+// Text of any length is accepted: past 450 characters the wrapper splits it
+// at punctuation or whitespace and speaks the pieces back to back, still as
+// one utterance with one DONE (bl_addTextUtteranceW does the same).
 BL_API int __cdecl bl_startSpeakW(BL_STATE* s, const wchar_t* text, int noIntonation);
 
+// Flags for bl_startSpeakExW() / bl_commitUtteranceEx().
+// PRIORITY: queue in the priority lane. It runs before anything waiting in the
+//           normal lane, and a composite utterance already speaking gives way
+//           at its next part boundary, ending with DONE value
+//           BL_DONE_PREEMPTED instead of 0.
+// RESUME:   with PRIORITY, afterwards re-queue the preempted utterance from
+//           its last index marker reached (that INDEX is sent again).
+#define BL_SPEAK_PRIORITY 1
+#define BL_SPEAK_RESUME   2
+#define BL_DONE_PREEMPTED 1
+
+BL_API int __cdecl bl_startSpeakExW(BL_STATE* s, const wchar_t* text, int noIntonation, int flags);
+
+// Hungarian text normalization before the text reaches the engine (off by
+// default). NUMBERS: cardinals, ordinals (3. fejezet), decimals (3,14),
+// dates (2024. 03. 15.) and digit strings; ABBREVIATIONS: common ones such as
+// pl., stb., kb., dr., units and month names; SYMBOLS: % & + = < > @ $ and the
+// section, degree and euro signs.
+// Applies from the next utterance. Returns 0 on success, 2 on unknown flags.
+#define BL_NORM_NUMBERS       1
+#define BL_NORM_ABBREVIATIONS 2
+#define BL_NORM_SYMBOLS       4
+#define BL_NORM_ALL           7
+
+BL_API int __cdecl bl_setNormalization(BL_STATE* s, int flags);
+
+// User pronunciation dictionary, compiled from a "word<TAB>replacement" list by
+// tools/compile_dict.py. Keys replace whole words, case-insensitively, longest
+// match first, before normalization. The file is mapped read-only; loading a
+// new one (or NULL / "" to drop it) while speaking is safe and takes effect
+// from the next utterance. Returns 0 on success, 2 if the file can't be
+// opened or isn't a valid dictionary (the current one stays).
+// The file stays mapped until the worker picks up its replacement at the
+// start of the next utterance, and on Windows a mapped file can't be
+// rewritten: compile an update to a new name and load that, then delete the
+// old file once something has been spoken.
+BL_API int __cdecl bl_loadDictionaryW(BL_STATE* s, const wchar_t* path);
+
+// Command coalescing, for bursts of short bl_startSpeakW() calls (typing echo).
+// Applies within a lane, to plain speak commands the worker hasn't started,
+// whatever their length.
+// OFF (default): every command is spoken in turn.
+// LATEST:        a new one drops those still waiting.
+// MERGE:         a new one is appended (after a space) to the newest one
+//                waiting, if that has the same noIntonation.
+// Utterances from bl_commitUtterance() are never dropped or merged: the host
+// waits on their index markers. Dropped commands produce no output at all,
+// like commands dropped by bl_stop().
+#define BL_COALESCE_OFF    0
+#define BL_COALESCE_LATEST 1
+#define BL_COALESCE_MERGE  2
+
+// maxDepth: at most this many plain speak commands wait per lane, the oldest
+// going first (0 = no limit, else 1-1024). Applies in any mode, from the next
+// command queued. Returns 0 on success, 2 on bad arguments.
+BL_API int __cdecl bl_setCoalescing(BL_STATE* s, int mode, int maxDepth);
+// Commands dropped and merged away since bl_initW. Returns 1.
+BL_API int __cdecl bl_getCoalesceStats(BL_STATE* s, uint32_t* dropped, uint32_t* merged);
+
 // New composite utterance API (FlexVoice-style):
 // Build a single wrapper utterance made of multiple text chunks, with index markers.
 // Typical flow:
@@ -51,6 +153,7 @@ BL_API int __cdecl bl_beginUtterance(BL_STATE* s, int noIntonation);
 BL_API int __cdecl bl_addTextUtteranceW(BL_STATE* s, const wchar_t* text);
 BL_API int __cdecl bl_addIndexUtterance(BL_STATE* s, int index);
 BL_API int __cdecl bl_commitUtterance(BL_STATE* s);
+BL_API int __cdecl bl_commitUtteranceEx(BL_STATE* s, int flags);
 
 // Read next item from the wrapper output queue.
 //
@@ -59,9 +162,17 @@ BL_API int __cdecl bl_commitUtterance(BL_STATE* s);
 // - *outValue meaning depends on *outType:
 //     * BL_ITEM_AUDIO: number of bytes copied into outAudio.
 //     * BL_ITEM_INDEX: the index value.
-//     * BL_ITEM_DONE: 0.
-//     * BL_ITEM_ERROR: error code (wrapper-defined).
-// - outAudio: buffer to receive audio bytes for BL_ITEM_AUDIO.
+//     * BL_ITEM_DONE: 0, or BL_DONE_PREEMPTED.
+//     * BL_ITEM_ERROR: error code (wrapper-defined):
+//         1001 StartSay failed.
+//         1002 the engine overran its deadline (scaled from the text length
+//              and the speech rate seen so far, 8 s to 180 s).
+//         1003 the engine made no audio progress for 5 s.
+//       After 1002/1003 the engine is stopped and initialized again.
+//       An ERROR is always followed by that utterance's DONE; keep reading
+//       up to it, or the next utterance will take it for its own.
+// - outAudio: buffer to receive audio bytes for BL_ITEM_AUDIO. Consecutive
+//   audio of one utterance is read as one item, up to outCap bytes.
 // - outCap: capacity of outAudio in bytes.
 //
 // Return value:
@@ -69,6 +180,160 @@ BL_API int __cdecl bl_commitUtterance(BL_STATE* s);
 // - If no items are available: sets *outType=BL_ITEM_NONE and returns 0.
 BL_API int __cdecl bl_read(BL_STATE* s, int* outType, int* outValue, uint8_t* outAudio, int outCap);
 
+// Batched bl_read(): drain as many queued items as fit in one call.
+//
+// Fills up to maxItems descriptors in order, copying audio back to back into
+// `audio` (capacity audioCap). Consecutive audio is merged into a single
+// descriptor. Stops early after a DONE or ERROR item, when either array is
+// full, or when the queue is empty.
+//
+// Returns the number of descriptors filled (0 if nothing was queued) and the
+// audio bytes used in *outAudioBytes.
+BL_API int __cdecl bl_readMany(BL_STATE* s, BL_READ_ITEM* items, int maxItems, uint8_t* audio, int audioCap, int* outAudioBytes);
+
+// Blocking bl_read(): waits up to timeoutMs (negative = no limit) for an item.
+// Wakes as soon as audio or a marker is queued, and immediately on bl_stop().
+// Returns like bl_read(); on timeout or stop, *outType=BL_ITEM_NONE and 0.
+// While another thread holds a bl_acquireAudio() view or renders, it keeps
+// waiting until that is over.
+//
+// With outAudio=NULL it only waits: nothing is consumed, and it returns 1 once
+// an item is ready (read it with bl_read() or bl_acquireAudio()), else 0.
+BL_API int __cdecl bl_readWait(BL_STATE* s, int timeoutMs, int* outType, int* outValue, uint8_t* outAudio, int outCap);
+
+// Zero-copy alternative to bl_read(): look at the next item in place.
+//
+// Same item types and *outValue meaning as bl_read(). For BL_ITEM_AUDIO,
+// *outData/*outLen describe the queued PCM in place: the rest of the next
+// block plus any following audio of the same utterance that sits right after
+// it in memory (usually the whole buffer the engine wrote). For markers they
+// are NULL/0.
+//
+// Returns 1 if an item was acquired, else 0 with *outType=BL_ITEM_NONE.
+// Every acquired item must be handed back with bl_releaseAudio(), which is
+// what removes it from the queue. The view stays valid until then, even across
+// bl_stop(). While an item is held, bl_read() and bl_acquireAudio() return
+// BL_ITEM_NONE, and bl_readWait() on other threads waits for the release.
+BL_API int  __cdecl bl_acquireAudio(BL_STATE* s, int* outType, int* outValue, const uint8_t** outData, int* outLen);
+BL_API void __cdecl bl_releaseAudio(BL_STATE* s);
+
+// Push-mode alternative to the read calls: invoked on a wrapper-owned thread
+// for every stream item, in the same order and with the same generation
+// filtering and DONE semantics as bl_read(). type/value are what bl_read()
+// would report; pcm/len hold the audio (NULL/0 for markers) and are only
+// valid for the duration of the call.
+typedef void (__cdecl *BL_AUDIO_SINK)(void* user, int type, int value, const uint8_t* pcm, int len);
+
+// Register a sink, or remove it with sink=NULL. While a sink is set it owns
+// the stream: don't read with bl_read*()/bl_acquireAudio() as well.
+// Removing (or replacing) returns only once the old sink is no longer being
+// called, unless it is called from inside the sink itself. Returns 0.
+BL_API int __cdecl bl_setAudioSink(BL_STATE* s, BL_AUDIO_SINK sink, void* user);
+
+// Offline render: synthesize `text` as fast as the engine can go (no pacing;
+// hook callbacks complete at once) and return when its DONE is reached.
+// Any current speech is stopped first, and the render goes ahead of anything
+// queued meanwhile; coalescing never drops or merges it. Refused while a sink
+// is set. Until it returns, the calling thread owns the stream: bl_read*()
+// and bl_acquireAudio() on other threads get BL_ITEM_NONE, and bl_readWait()
+// waits.
+// - buf/bufCap: caller buffer. *outBytes receives the full length even if it
+//   didn't fit (then the result is 3 and buf holds the first bufCap bytes).
+// - buf=NULL: the wrapper allocates; *outAlloc receives the PCM (NULL if
+//   there was none), to be freed with bl_freeBuffer().
+// Returns 0 on success, 1 if busy/stopped meanwhile, 2 on bad arguments,
+// 3 if buf was too small, 4 if the engine reported an error, 5 if no output
+// came for 30 s (the render is stopped).
+BL_API int  __cdecl bl_renderToBufferW(BL_STATE* s, const wchar_t* text, int noIntonation, uint8_t* buf, int bufCap, uint8_t** outAlloc, int* outBytes);
+BL_API void __cdecl bl_freeBuffer(uint8_t* p);
+
+// Publish the output stream into a named shared-memory ring for a reader in
+// another process (layout in src/bl_shm.h). Items go in order with the same
+// filtering as bl_read(); bl_stop() invalidates whatever the reader has not
+// consumed yet. This runs on the bl_setAudioSink() delivery thread, so it
+// replaces any registered sink. capacityBytes is rounded up to a power of
+// two, at least 64 KB (0 = default).
+// Returns 0 on success, 1 if the region could not be created (e.g. the name
+// is taken), 2 on bad arguments.
+BL_API int  __cdecl bl_openSharedOutput(BL_STATE* s, const char* name, int capacityBytes);
+BL_API void __cdecl bl_closeSharedOutput(BL_STATE* s);
+
+// Select BL_OVERFLOW_BLOCK or BL_OVERFLOW_DROP. Returns 0 on success.
+BL_API int __cdecl bl_setOverflowPolicy(BL_STATE* s, int policy);
+
+// Select BL_PACING_LOOKAHEAD or BL_PACING_REALTIME. Returns 0 on success.
+BL_API int __cdecl bl_setPacingMode(BL_STATE* s, int mode);
+
+// Pacing budget, in milliseconds of audio:
+// - burstMs:       REALTIME: generated without sleeping at utterance start (0-10000).
+// - lookaheadMs:   LOOKAHEAD: queued before the engine waits for the reader (10-60000).
+// - maxBufferedMs: queue limit where the overflow policy kicks in (1000-600000,
+//                  at least lookaheadMs).
+// Pass a negative value to keep a setting. Changes apply from the next
+// utterance. Returns 0 on success, 2 if a value is out of range.
+BL_API int __cdecl bl_setLookaheadMs(BL_STATE* s, int burstMs, int lookaheadMs, int maxBufferedMs);
+// Current settings (as the next utterance will use them). Returns 1.
+BL_API int __cdecl bl_getLookaheadMs(BL_STATE* s, int* burstMs, int* lookaheadMs, int* maxBufferedMs);
+
+// Overflow counters since bl_initW: audio discarded (bytes and blocks) and the
+// number of times the engine thread (or the worker, for a marker) had to wait
+// for the reader. Returns 1.
+BL_API int __cdecl bl_getOverflowStats(BL_STATE* s, uint64_t* droppedBytes, uint32_t* droppedBlocks, uint32_t* blockedWaits);
+
+// Latency timeline of one wrapper utterance (one bl_startSpeakW() or
+// bl_commitUtterance()). Times are microseconds after the command was queued;
+// -1 means the point was never reached (e.g. stopped first).
+#define BL_STATS_HISTORY 32
+#define BL_UTT_STOPPED 1
+#define BL_UTT_ERROR   2
+#define BL_UTT_PREEMPTED 4
+
+typedef struct BL_UTTERANCE_TIMES {
+	uint32_t id;            // wrapper generation, increasing
+	int32_t flags;          // BL_UTT_*
+	int32_t dequeueUs;      // worker picked it up
+	int32_t startSayUs;     // first StartSay call into the engine
+	int32_t firstCaptureUs; // first audio in waveOutWrite
+	int32_t firstReadUs;    // first audio handed to the host (any read call or the sink)
+	int32_t engineDoneUs;   // engine done callback (the last one, for composites)
+	int32_t doneUs;         // DONE marker emitted
+} BL_UTTERANCE_TIMES;
+
+typedef struct BL_PERCENTILES {
+	int32_t p50Us;
+	int32_t p90Us;
+	int32_t p99Us;
+	int32_t maxUs;
+} BL_PERCENTILES;
+
+typedef struct BL_STATS {
+	uint32_t utterances;  // finished since bl_initW
+	uint32_t count;       // valid entries in recent[]
+	BL_UTTERANCE_TIMES recent[BL_STATS_HISTORY]; // oldest first
+	// Over the recent[] entries that got that far:
+	BL_PERCENTILES firstCapture; // queued -> engine produced audio
+	BL_PERCENTILES firstRead;    // queued -> host got audio (time-to-first-audio)
+} BL_STATS;
+
+// Snapshot the last BL_STATS_HISTORY finished utterances. Cheap enough to poll;
+// the timestamps themselves are taken on the hot paths without locks.
+// Returns 1, or 0 on bad arguments.
+BL_API int __cdecl bl_getStats(BL_STATE* s, BL_STATS* out);
+
+// Stop latency, over the last BL_STATS_HISTORY bl_stop() calls that cut an
+// utterance short, in microseconds after bl_stop(). The host stops getting
+// audio at once (queued audio is invalidated inside bl_stop()); these measure
+// how long the engine takes to go quiet behind it.
+typedef struct BL_STOP_STATS {
+	uint32_t stops;            // measured since bl_initW
+	uint32_t count;            // samples behind the percentiles
+	BL_PERCENTILES engineStop; // TTS_Stop returned on the worker
+	BL_PERCENTILES idle;       // engine thread out of the audio hooks: the next utterance can start
+} BL_STOP_STATS;
+
+// Returns 1, or 0 on bad arguments.
+BL_API int __cdecl bl_getStopStats(BL_STATE* s, BL_STOP_STATS* out);
+
 // Voice controls.
 BL_API int  __cdecl bl_getTempo(BL_STATE* s);
 BL_API void __cdecl bl_setTempo(BL_STATE* s, int tempo);
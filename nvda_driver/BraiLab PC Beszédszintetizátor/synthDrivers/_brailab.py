@@ -12,7 +12,7 @@ import os
 import queue
 import threading
 import time
-from typing import Any, Callable, Dict, Optional, Tuple
+from typing import Any, Callable, Dict, List, Optional, Tuple
 
 LOGGER = logging.getLogger(__name__)
 
@@ -23,6 +23,25 @@ BL_ITEM_DONE = 2
 BL_ITEM_ERROR = 3
 BL_ITEM_INDEX = 4
 
+# bl_getFeatures() bits
+BL_FEATURE_CHUNKING = 1
+
+# Upper bound for one bl_readWait park; _should_stop is re-checked after it.
+READ_WAIT_MS = 50
+
+# Descriptors per bl_readMany call.
+READ_MANY_ITEMS = 64
+
+
+class BL_READ_ITEM(ctypes.Structure):
+	_fields_ = [
+		("type", ctypes.c_int),
+		("value", ctypes.c_int),
+		("audioOffset", ctypes.c_int),
+		("audioLen", ctypes.c_int),
+	]
+
+
 AudioChunk = Tuple[bytes, Optional[int], bool, int]  # (data, index, is_final, seq)
 
 
@@ -134,6 +153,10 @@ class BrailabDirectClient:
 		self._audio_worker: Optional[AudioWorker] = None
 		self._should_stop = False
 		self._has_composite = False
+		self._has_zero_copy = False
+		self._has_read_wait = False
+		self._has_read_many = False
+		self._wrapper_chunks = False
 		self._sequence = 0
 		self._current_seq = 0
 		# Audio format
@@ -145,6 +168,9 @@ class BrailabDirectClient:
 		self._audio_buf = None
 		self._out_type = None
 		self._out_value = None
+		self._out_data = None
+		self._out_len = None
+		self._read_items_buf = None
 
 	def ensure_started(self) -> None:
 		pass  # No host process needed
@@ -158,6 +184,9 @@ class BrailabDirectClient:
 		self._audio_buf = ctypes.create_string_buffer(self._buf_size)
 		self._out_type = ctypes.c_int(0)
 		self._out_value = ctypes.c_int(0)
+		self._out_data = ctypes.c_void_p(None)
+		self._out_len = ctypes.c_int(0)
+		self._read_items_buf = (BL_READ_ITEM * READ_MANY_ITEMS)()
 
 		self._handle = self._dll.bl_initW(tts_path, init_value)
 		if not self._handle:
@@ -173,6 +202,34 @@ class BrailabDirectClient:
 		except AttributeError:
 			self._has_composite = False
 
+		# Detect zero-copy read API
+		try:
+			_ = self._dll.bl_acquireAudio
+			_ = self._dll.bl_releaseAudio
+			self._has_zero_copy = True
+		except AttributeError:
+			self._has_zero_copy = False
+
+		# Detect blocking read
+		try:
+			_ = self._dll.bl_readWait
+			self._has_read_wait = True
+		except AttributeError:
+			self._has_read_wait = False
+
+		# Detect batched read
+		try:
+			_ = self._dll.bl_readMany
+			self._has_read_many = True
+		except AttributeError:
+			self._has_read_many = False
+
+		# Wrappers that split long text themselves report it (newer wrappers only)
+		try:
+			self._wrapper_chunks = bool(self._dll.bl_getFeatures() & BL_FEATURE_CHUNKING)
+		except AttributeError:
+			self._wrapper_chunks = False
+
 		# Query audio format
 		sr = ctypes.c_int(0)
 		ch = ctypes.c_int(0)
@@ -193,6 +250,7 @@ class BrailabDirectClient:
 				"bitsPerSample": self._bits_per_sample,
 			},
 			"hasComposite": self._has_composite,
+			"wrapperChunks": self._wrapper_chunks,
 			"tempo": self._dll.bl_getTempo(self._handle),
 			"pitch": self._dll.bl_getPitch(self._handle),
 			"volume": self._dll.bl_getVolume(self._handle),
@@ -247,6 +305,52 @@ class BrailabDirectClient:
 			dll.bl_commitUtterance.restype = ctypes.c_int
 		except AttributeError:
 			pass
+		# Zero-copy read API (optional)
+		try:
+			dll.bl_acquireAudio.argtypes = (
+				ctypes.c_void_p,
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_void_p),
+				ctypes.POINTER(ctypes.c_int),
+			)
+			dll.bl_acquireAudio.restype = ctypes.c_int
+			dll.bl_releaseAudio.argtypes = (ctypes.c_void_p,)
+			dll.bl_releaseAudio.restype = None
+		except AttributeError:
+			pass
+		# Blocking read (optional)
+		try:
+			dll.bl_readWait.argtypes = (
+				ctypes.c_void_p,
+				ctypes.c_int,
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.c_void_p,
+				ctypes.c_int,
+			)
+			dll.bl_readWait.restype = ctypes.c_int
+		except AttributeError:
+			pass
+		# Feature bits (optional)
+		try:
+			dll.bl_getFeatures.argtypes = ()
+			dll.bl_getFeatures.restype = ctypes.c_int
+		except AttributeError:
+			pass
+		# Batched read (optional)
+		try:
+			dll.bl_readMany.argtypes = (
+				ctypes.c_void_p,
+				ctypes.POINTER(BL_READ_ITEM),
+				ctypes.c_int,
+				ctypes.c_void_p,
+				ctypes.c_int,
+				ctypes.POINTER(ctypes.c_int),
+			)
+			dll.bl_readMany.restype = ctypes.c_int
+		except AttributeError:
+			pass
 
 	# ------------------------------------------------------------------
 	# Audio
@@ -305,38 +409,101 @@ class BrailabDirectClient:
 			return
 		self._read_loop()
 
+	def _read_item(self) -> Tuple[int, int, bytes]:
+		"""Take the next item off the wrapper queue as (type, value, audio)."""
+		if self._has_zero_copy:
+			got = self._dll.bl_acquireAudio(
+				self._handle,
+				ctypes.byref(self._out_type),
+				ctypes.byref(self._out_value),
+				ctypes.byref(self._out_data),
+				ctypes.byref(self._out_len),
+			)
+			if not got:
+				return BL_ITEM_NONE, 0, b""
+			try:
+				n = self._out_len.value
+				# The only copy of the PCM on this side: straight out of the wrapper's block.
+				data = ctypes.string_at(self._out_data.value, n) if n > 0 else b""
+			finally:
+				self._dll.bl_releaseAudio(self._handle)
+			return self._out_type.value, self._out_value.value, data
+
+		n = self._dll.bl_read(
+			self._handle,
+			ctypes.byref(self._out_type),
+			ctypes.byref(self._out_value),
+			self._audio_buf,
+			self._buf_size,
+		)
+		t = self._out_type.value
+		data = ctypes.string_at(self._audio_buf, n) if (t == BL_ITEM_AUDIO and n > 0) else b""
+		return t, self._out_value.value, data
+
+	def _wait_for_item(self) -> None:
+		"""Block until the wrapper has something queued (or a short timeout)."""
+		if self._has_read_wait:
+			# Wait-only call (no buffer): wakes on new audio/markers and on bl_stop.
+			self._dll.bl_readWait(self._handle, READ_WAIT_MS, ctypes.byref(self._out_type),
+								  ctypes.byref(self._out_value), None, 0)
+		else:
+			time.sleep(0.001)
+
+	def _read_items(self) -> List[Tuple[int, int, bytes]]:
+		"""Drain what the wrapper has queued; one ctypes call when bl_readMany exists."""
+		if not self._has_read_many:
+			t, v, data = self._read_item()
+			return [] if t == BL_ITEM_NONE else [(t, v, data)]
+
+		count = self._dll.bl_readMany(
+			self._handle,
+			self._read_items_buf,
+			READ_MANY_ITEMS,
+			self._audio_buf,
+			self._buf_size,
+			ctypes.byref(self._out_len),
+		)
+		base = ctypes.addressof(self._audio_buf)
+		items = []
+		for i in range(count):
+			d = self._read_items_buf[i]
+			data = ctypes.string_at(base + d.audioOffset, d.audioLen) if d.audioLen > 0 else b""
+			items.append((d.type, d.value, data))
+		return items
+
 	def _read_loop(self) -> None:
-		"""Poll bl_read() and push audio chunks to the queue."""
+		"""Poll the wrapper and push audio chunks to the queue."""
+		failed = False
 		while not self._should_stop:
 			try:
-				n = self._dll.bl_read(
-					self._handle,
-					ctypes.byref(self._out_type),
-					ctypes.byref(self._out_value),
-					self._audio_buf,
-					self._buf_size,
-				)
+				items = self._read_items()
 			except Exception:
 				LOGGER.exception("bl_read crashed")
 				self._audio_queue.put((b"", None, True, self._current_seq))
 				return
 
-			t = self._out_type.value
-			v = self._out_value.value
+			if not items:
+				self._wait_for_item()
+				continue
 
-			if t == BL_ITEM_AUDIO and n > 0:
-				self._audio_queue.put((bytes(self._audio_buf.raw[:n]), None, False, self._current_seq))
-			elif t == BL_ITEM_INDEX:
-				self._audio_queue.put((b"", v, False, self._current_seq))
-			elif t == BL_ITEM_DONE:
-				self._audio_queue.put((b"", None, True, self._current_seq))
-				return
-			elif t == BL_ITEM_ERROR:
-				LOGGER.error("Wrapper error %d", v)
-				self._audio_queue.put((b"", None, True, self._current_seq))
-				return
-			elif t == BL_ITEM_NONE:
-				time.sleep(0.001)
+			for t, v, data in items:
+				if failed:
+					# ERROR is always followed by the utterance's own DONE; read up
+					# to it, or the next utterance would take it for its own.
+					if t == BL_ITEM_DONE:
+						return
+					continue
+				if t == BL_ITEM_AUDIO and data:
+					self._audio_queue.put((data, None, False, self._current_seq))
+				elif t == BL_ITEM_INDEX:
+					self._audio_queue.put((b"", v, False, self._current_seq))
+				elif t == BL_ITEM_DONE:
+					self._audio_queue.put((b"", None, True, self._current_seq))
+					return
+				elif t == BL_ITEM_ERROR:
+					LOGGER.error("Wrapper error %d", v)
+					self._audio_queue.put((b"", None, True, self._current_seq))
+					failed = True
 
 	# ------------------------------------------------------------------
 	# Control
@@ -398,11 +565,12 @@ _client: BrailabDirectClient = BrailabDirectClient()
 _on_index_reached: Optional[Callable] = None
 _format: Dict[str, int] = {}
 _has_composite: bool = False
+_wrapper_chunks: bool = False
 
 
 def initialize(index_callback=None) -> Dict[str, Any]:
 	"""Load the DLL and initialize the engine."""
-	global _on_index_reached, _format, _has_composite
+	global _on_index_reached, _format, _has_composite, _wrapper_chunks
 	_on_index_reached = index_callback
 
 	addon_dir = os.path.abspath(os.path.dirname(__file__))
@@ -413,6 +581,7 @@ def initialize(index_callback=None) -> Dict[str, Any]:
 
 	_format = result.get("format", {})
 	_has_composite = result.get("hasComposite", False)
+	_wrapper_chunks = result.get("wrapperChunks", False)
 
 	_client.initialize_audio(
 		channels=_format.get("channels", 1),
@@ -427,6 +596,11 @@ def has_composite() -> bool:
 	return _has_composite
 
 
+def wrapper_chunks() -> bool:
+	"""True if the wrapper splits text over the engine's limit itself."""
+	return _wrapper_chunks
+
+
 def speak(text: str, no_intonation: int = 0) -> None:
 	"""Legacy single-chunk speech (blocks until done)."""
 	_client.do_speak(text, no_intonation)
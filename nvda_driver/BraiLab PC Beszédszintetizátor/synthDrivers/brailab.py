@@ -174,6 +174,7 @@ class SynthDriver(SynthDriver):
 		result = _brailab.initialize(index_callback=_indexCallback)
 
 		self._hasComposite = _brailab.has_composite()
+		self._wrapperChunks = _brailab.wrapper_chunks()
 
 		# Cache initial parameter values from the host
 		self._cachedTempo = result.get("tempo", 4)
@@ -313,6 +314,13 @@ class SynthDriver(SynthDriver):
 		else:
 			_execWhenDone(self._speakBg, blocks, mustBeAsync=True)
 
+	def _segments(self, text):
+		# Newer wrappers split long text at punctuation/whitespace themselves;
+		# older ones need it cut to the engine's limit here.
+		if self._wrapperChunks:
+			return [text]
+		return [text[i:i + MAX_STRING_LENGTH] for i in range(0, len(text), MAX_STRING_LENGTH)]
+
 	def _speakBgComposite(self, blocks):
 		"""Speak using the composite utterance API via IPC."""
 		self.speaking = True
@@ -331,8 +339,7 @@ class SynthDriver(SynthDriver):
 				break
 
 			if text:
-				segments = [text[i:i + MAX_STRING_LENGTH] for i in range(0, len(text), MAX_STRING_LENGTH)]
-				for seg in segments:
+				for seg in self._segments(text):
 					if not self.speaking:
 						break
 					seg = _brailabSafeText(seg)
@@ -382,8 +389,7 @@ class SynthDriver(SynthDriver):
 				break
 
 			if text:
-				segments = [text[i:i + MAX_STRING_LENGTH] for i in range(0, len(text), MAX_STRING_LENGTH)]
-				for seg in segments:
+				for seg in self._segments(text):
 					if not self.speaking:
 						break
 					seg = _brailabSafeText(seg)
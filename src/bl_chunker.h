@@ -0,0 +1,80 @@
+// bl_chunker.h
+//
+// Splits long text for StartSay where Brailab would pause anyway: after
+// sentence and clause punctuation, else at whitespace, so a chunk only ends
+// mid-word when a single word is over the limit. Plain C++17 like bl_ring.h,
+// so the split rules can be exercised away from tts.dll.
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Longest text handed to one StartSay (the limit the drivers sliced at).
+static const size_t kChunkMaxChars = 450;
+
+inline bool blIsSpaceUnit(wchar_t c) {
+	return c == L' ' || c == L'\t' || c == L'\r' || c == L'\n' || c == 0x00A0;
+}
+
+// How good a place to end a chunk is right after `c`: sentence ends best,
+// then ';' and ':', then ',', then any other word end.
+inline int blBreakRank(wchar_t c) {
+	switch (c) {
+	case L'.': case L'?': case L'!': case 0x2026: return 4;
+	case L';': case L':': return 3;
+	case L',': return 2;
+	default: return 1;
+	}
+}
+
+// End of the chunk that starts at `from`, given more than `maxChars` units
+// are left. Takes the best-ranked word end in the last two thirds of the
+// window (the latest of equals), any word end if there is none, and a hard
+// cut only when the window holds a single word.
+inline size_t blFindBreak(const std::wstring& text, size_t from, size_t maxChars) {
+	const size_t limit = from + maxChars;
+	const size_t floor = from + maxChars / 3;
+
+	size_t best = 0;
+	int bestRank = 0;
+	size_t anyEnd = 0;
+	for (size_t i = limit; i > from; --i) {
+		// A word ends between text[i-1] and text[i].
+		if (!blIsSpaceUnit(text[i]) || blIsSpaceUnit(text[i - 1])) continue;
+		if (i < floor) {
+			anyEnd = i;
+			break;
+		}
+		const int rank = blBreakRank(text[i - 1]);
+		if (rank > bestRank) {
+			best = i;
+			bestRank = rank;
+			if (rank == 4) break;
+		}
+	}
+	if (best) return best;
+	if (anyEnd) return anyEnd;
+
+	// Don't split a surrogate pair.
+	size_t cut = limit;
+	if (text[cut] >= 0xDC00 && text[cut] <= 0xDFFF && cut - 1 > from) --cut;
+	return cut;
+}
+
+// `text` as chunks of at most `maxChars` units, with the whitespace at each
+// split dropped. Text that already fits comes back as one piece, untouched.
+inline std::vector<std::wstring> blChunkText(const std::wstring& text, size_t maxChars = kChunkMaxChars) {
+	std::vector<std::wstring> chunks;
+	if (maxChars < 3) maxChars = 3;
+
+	size_t pos = 0;
+	while (text.size() - pos > maxChars) {
+		const size_t end = blFindBreak(text, pos, maxChars);
+		chunks.push_back(text.substr(pos, end - pos));
+		pos = end;
+		while (pos < text.size() && blIsSpaceUnit(text[pos])) ++pos;
+	}
+	if (pos < text.size() || chunks.empty()) chunks.push_back(text.substr(pos));
+	return chunks;
+}
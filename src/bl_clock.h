@@ -0,0 +1,139 @@
+// bl_clock.h
+//
+// Monotonic microsecond clock and absolute-deadline waits for pacing and the
+// end-of-utterance checks. On Win32 this is QueryPerformanceCounter plus a
+// high-resolution waitable timer (a plain waitable timer before Windows 10
+// 1803); elsewhere steady_clock and a condition variable, so the pacing code
+// can be exercised on Linux.
+#pragma once
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+// Windows 10 1803 SDK and later; older headers don't have it.
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#else
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#ifdef _WIN32
+
+// What a wait can be cut short by: a Win32 event (e.g. the wrapper's stopEvent).
+typedef HANDLE BlCancelHandle;
+
+inline int64_t blNowUs() {
+	static const int64_t freq = []() {
+		LARGE_INTEGER f;
+		QueryPerformanceFrequency(&f);
+		return (int64_t)f.QuadPart;
+	}();
+	LARGE_INTEGER t;
+	QueryPerformanceCounter(&t);
+	return (t.QuadPart / freq) * 1000000 + ((t.QuadPart % freq) * 1000000) / freq;
+}
+
+#else
+
+// Portable stand-in for a manual-reset event.
+class BlCancelEvent {
+public:
+	void set() {
+		{
+			std::lock_guard<std::mutex> g(mtx);
+			signaled = true;
+		}
+		cv.notify_all();
+	}
+	void reset() {
+		std::lock_guard<std::mutex> g(mtx);
+		signaled = false;
+	}
+
+private:
+	friend class BlPacingTimer;
+	std::mutex mtx;
+	std::condition_variable cv;
+	bool signaled = false;
+};
+
+typedef BlCancelEvent* BlCancelHandle;
+
+inline int64_t blNowUs() {
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
+
+// How late waitUntil() may wake on a machine that isn't overloaded: it never
+// returns before the deadline, and nine waits in ten are within this after it.
+static const int64_t kBlPacingToleranceUs = 1000;
+
+// One timer per waiting thread: waitUntil() re-arms it every call.
+class BlPacingTimer {
+public:
+#ifdef _WIN32
+	BlPacingTimer() {
+		timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		// Systems before 1803 reject the flag; a normal timer still beats Sleep().
+		if (!timer) timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+	}
+	~BlPacingTimer() {
+		if (timer) CloseHandle(timer);
+	}
+#else
+	BlPacingTimer() = default;
+#endif
+
+	BlPacingTimer(const BlPacingTimer&) = delete;
+	BlPacingTimer& operator=(const BlPacingTimer&) = delete;
+
+	// Sleep until blNowUs() >= deadlineUs, or until `cancel` (may be null) is
+	// signaled. Returns false if it was cancelled, true once the deadline passed.
+	bool waitUntil(int64_t deadlineUs, BlCancelHandle cancel) {
+#ifdef _WIN32
+		const int64_t now = blNowUs();
+		if (deadlineUs <= now) return !(cancel && WaitForSingleObject(cancel, 0) == WAIT_OBJECT_0);
+
+		LARGE_INTEGER due;
+		due.QuadPart = -(LONGLONG)((deadlineUs - now) * 10); // relative, 100 ns units
+		if (!timer || !SetWaitableTimer(timer, &due, 0, nullptr, nullptr, FALSE)) {
+			// No timer: millisecond sleep, rounded up so we never wake early.
+			const DWORD ms = (DWORD)((deadlineUs - now + 999) / 1000);
+			if (cancel) return WaitForSingleObject(cancel, ms) != WAIT_OBJECT_0;
+			Sleep(ms);
+			return true;
+		}
+		if (!cancel) {
+			WaitForSingleObject(timer, INFINITE);
+			return true;
+		}
+		HANDLE waits[2] = { cancel, timer };
+		const DWORD w = WaitForMultipleObjects(2, waits, FALSE, INFINITE);
+		if (w == WAIT_OBJECT_0) {
+			CancelWaitableTimer(timer);
+			return false;
+		}
+		return true;
+#else
+		const auto deadline = std::chrono::steady_clock::time_point(std::chrono::microseconds(deadlineUs));
+		if (!cancel) {
+			std::this_thread::sleep_until(deadline);
+			return true;
+		}
+		std::unique_lock<std::mutex> lk(cancel->mtx);
+		return !cancel->cv.wait_until(lk, deadline, [&]() { return cancel->signaled; });
+#endif
+	}
+
+private:
+#ifdef _WIN32
+	HANDLE timer = nullptr;
+#endif
+};
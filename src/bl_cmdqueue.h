@@ -0,0 +1,121 @@
+// bl_cmdqueue.h
+//
+// The worker's command queue: one FIFO per lane, priority lane first. Like
+// bl_ring.h this is plain C++17 (no Windows headers), so the scheduling rules
+// can be exercised away from tts.dll. Not thread-safe by itself: the wrapper
+// guards it with cmdMtx.
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <utility>
+#include <vector>
+
+enum CmdLane {
+	LANE_NORMAL = 0,
+	LANE_PRIORITY = 1,
+	LANE_COUNT = 2
+};
+
+template <typename T>
+class LaneQueue {
+public:
+	void push(T item, int lane) { lanes[clampLane(lane)].push_back(std::move(item)); }
+
+	// Put something back at the head of its lane (a preempted utterance's
+	// remainder goes ahead of whatever else was waiting behind it).
+	void pushFront(T item, int lane) { lanes[clampLane(lane)].push_front(std::move(item)); }
+
+	// Next command to run: the priority lane drains first, FIFO within a lane.
+	bool pop(T& out, int* outLane = nullptr) {
+		for (int lane = LANE_COUNT - 1; lane >= 0; --lane) {
+			if (lanes[lane].empty()) continue;
+			out = std::move(lanes[lane].front());
+			lanes[lane].pop_front();
+			if (outLane) *outLane = lane;
+			return true;
+		}
+		return false;
+	}
+
+	const T* peek(int lane) const {
+		const std::deque<T>& q = lanes[clampLane(lane)];
+		return q.empty() ? nullptr : &q.front();
+	}
+
+	// Newest command waiting in a lane (coalescing merges into it).
+	T* back(int lane) {
+		std::deque<T>& q = lanes[clampLane(lane)];
+		return q.empty() ? nullptr : &q.back();
+	}
+
+	// Drop every waiting command of a lane that matches. Returns how many went.
+	template <typename Pred>
+	size_t removeIf(int lane, Pred pred) {
+		std::deque<T>& q = lanes[clampLane(lane)];
+		const size_t before = q.size();
+		q.erase(std::remove_if(q.begin(), q.end(), pred), q.end());
+		return before - q.size();
+	}
+
+	// Drop the oldest matching commands of a lane until at most `keep` of them
+	// are left. Returns how many went.
+	template <typename Pred>
+	size_t trimOldest(int lane, size_t keep, Pred pred) {
+		std::deque<T>& q = lanes[clampLane(lane)];
+		size_t matching = 0;
+		for (const T& item : q) {
+			if (pred(item)) ++matching;
+		}
+		if (matching <= keep) return 0;
+		size_t excess = matching - keep;
+		const size_t dropped = excess;
+		for (auto it = q.begin(); it != q.end() && excess > 0;) {
+			if (pred(*it)) {
+				it = q.erase(it);
+				--excess;
+			} else {
+				++it;
+			}
+		}
+		return dropped;
+	}
+
+	bool hasPending(int lane) const { return !lanes[clampLane(lane)].empty(); }
+
+	bool empty() const {
+		for (const auto& q : lanes) {
+			if (!q.empty()) return false;
+		}
+		return true;
+	}
+
+	size_t size() const {
+		size_t n = 0;
+		for (const auto& q : lanes) n += q.size();
+		return n;
+	}
+
+	void clear() {
+		for (auto& q : lanes) q.clear();
+	}
+
+private:
+	static int clampLane(int lane) { return (lane == LANE_PRIORITY) ? LANE_PRIORITY : LANE_NORMAL; }
+
+	std::deque<T> lanes[LANE_COUNT];
+};
+
+// Where a preempted composite utterance picks up again, given that parts
+// [0, reached) were already spoken: at the last index marker reached, so the
+// host hears the stretch it was in again and gets that INDEX re-sent; from the
+// start if none was reached.
+template <typename Part, typename IsIndex>
+size_t resumePoint(const std::vector<Part>& parts, size_t reached, IsIndex isIndex) {
+	if (reached > parts.size()) reached = parts.size();
+	for (size_t i = reached; i-- > 0;) {
+		if (isIndex(parts[i])) return i;
+	}
+	return 0;
+}
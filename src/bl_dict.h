@@ -0,0 +1,230 @@
+// bl_dict.h
+//
+// User pronunciation dictionary: a file compiled by tools/compile_dict.py,
+// mapped read-only and searched in place. Words are replaced with the longest
+// matching key at each word start, so the cost follows the text, not the
+// number of entries. Backed by a Win32 file mapping or POSIX mmap like
+// bl_shm.h; the rest is plain C++17.
+//
+// On Windows the file can't be rewritten while a BlDictionary has it mapped,
+// so updates go to a new file, opened in a new BlDictionary; the old file is
+// free again once its BlDictionary is closed.
+//
+// Layout (all little-endian, offsets from the start of the file):
+//   BlDictHeader (64 bytes)
+//   alphabet  uint16[alphabetUnits]  code unit -> transition code, 0 = none;
+//                                    upper and lower case share a code
+//   base      int32[nodeCount]       double-array trie, root = node 0:
+//   check     int32[nodeCount]       child of n on code c is t = base[n] + c
+//                                    if check[t] == n
+//   value     int32[nodeCount]       replacement index ending at n, or -1
+//   textIndex uint32[valueCount + 1] replacement v is text[textIndex[v],
+//                                    textIndex[v + 1])
+//   text      uint16[unitCount]      UTF-16 replacements
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "bl_normalize.h"
+
+static const uint32_t BL_DICT_MAGIC = 0x54444C42u; // "BLDT"
+static const uint32_t BL_DICT_VERSION = 1;
+
+struct BlDictHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t alphabetUnits;
+	uint32_t nodeCount;
+	uint32_t valueCount;
+	uint32_t unitCount;
+	uint32_t alphabetOffset;
+	uint32_t baseOffset;
+	uint32_t checkOffset;
+	uint32_t valueOffset;
+	uint32_t textIndexOffset;
+	uint32_t textOffset;
+	uint32_t reserved[4];
+};
+
+static_assert(sizeof(BlDictHeader) == 64, "dictionary header layout is fixed by the compiler");
+
+// One compiled dictionary, mapped for as long as the object lives. Immutable
+// once open() has succeeded, so any number of threads can apply() it.
+class BlDictionary {
+public:
+	BlDictionary() = default;
+	~BlDictionary() { close(); }
+
+	BlDictionary(const BlDictionary&) = delete;
+	BlDictionary& operator=(const BlDictionary&) = delete;
+
+	bool loaded() const { return nodes != 0; }
+
+	// Maps `path` and checks it end to end, so apply() can trust every index
+	// without further bounds checks. False (and nothing mapped) if the file is
+	// missing, truncated or not a dictionary of this version.
+	bool open(const wchar_t* path) {
+		close();
+		if (!path || !*path || !map(path)) return false;
+		if (!validate()) { close(); return false; }
+		return true;
+	}
+
+	void close() {
+#ifdef _WIN32
+		if (base) UnmapViewOfFile(base);
+		if (handle) CloseHandle(handle);
+		handle = nullptr;
+#else
+		if (base) munmap(const_cast<uint8_t*>(base), length);
+#endif
+		base = nullptr;
+		length = 0;
+		nodes = 0;
+	}
+
+	// `in` with every dictionary word replaced, into `out` (cleared first).
+	// Keys match whole words only, case-insensitively; among keys starting at
+	// the same word, the longest one that ends on a word boundary wins.
+	void apply(const wchar_t* in, size_t len, std::wstring& out) const {
+		out.clear();
+		if (out.capacity() < len + len / 4) out.reserve(len + len / 4);
+
+		size_t i = 0;
+		while (i < len) {
+			if (!blIsWordUnit(in[i]) || (i > 0 && blIsWordUnit(in[i - 1]))) {
+				out.push_back(in[i++]);
+				continue;
+			}
+
+			int32_t node = 0;
+			int32_t best = -1;
+			size_t bestEnd = i;
+			for (size_t k = i; k < len; ++k) {
+				const uint32_t u = (uint32_t)in[k];
+				const uint32_t code = (u < alphabetUnits) ? alphabet[u] : 0;
+				if (!code) break;
+				const int64_t t = (int64_t)baseArr[node] + code;
+				if (t <= 0 || t >= (int64_t)nodes || checkArr[t] != node) break;
+				node = (int32_t)t;
+				if (valueArr[node] >= 0 && (k + 1 == len || !blIsWordUnit(in[k + 1]))) {
+					best = valueArr[node];
+					bestEnd = k + 1;
+				}
+			}
+
+			if (best >= 0) {
+				for (uint32_t p = textIndex[best]; p < textIndex[best + 1]; ++p) out.push_back((wchar_t)text[p]);
+				i = bestEnd;
+			} else {
+				// No key starts here: the rest of the word goes through as is.
+				do out.push_back(in[i++]); while (i < len && blIsWordUnit(in[i]));
+			}
+		}
+	}
+
+private:
+	bool map(const wchar_t* path) {
+#ifdef _WIN32
+		HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+		LARGE_INTEGER size = {};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(BlDictHeader) ||
+			size.QuadPart > 0x7FFFFFFF) {
+			CloseHandle(file);
+			return false;
+		}
+		// The mapping keeps the file open; the handle itself can go.
+		handle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		CloseHandle(file);
+		if (!handle) return false;
+		base = static_cast<const uint8_t*>(MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+		if (!base) { close(); return false; }
+		length = (size_t)size.QuadPart;
+#else
+		std::string narrow(wcslen(path) * 4 + 1, '\0');
+		const size_t n = wcstombs(&narrow[0], path, narrow.size());
+		if (n == (size_t)-1) return false;
+		narrow.resize(n);
+		const int fd = ::open(narrow.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(BlDictHeader) || st.st_size > 0x7FFFFFFF) {
+			::close(fd);
+			return false;
+		}
+		void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (p == MAP_FAILED) return false;
+		base = static_cast<const uint8_t*>(p);
+		length = (size_t)st.st_size;
+#endif
+		return true;
+	}
+
+	// Section of `count` elements of `size` bytes at `offset`, or null if it
+	// runs off the end of the file or isn't aligned for its type.
+	const void* section(uint32_t offset, uint32_t count, size_t size) const {
+		if (offset % size) return nullptr;
+		if ((uint64_t)offset + (uint64_t)count * size > length) return nullptr;
+		return base + offset;
+	}
+
+	bool validate() {
+		BlDictHeader h;
+		memcpy(&h, base, sizeof(h));
+		if (h.magic != BL_DICT_MAGIC || h.version != BL_DICT_VERSION) return false;
+		if (h.nodeCount == 0 || h.nodeCount > 0x7FFFFFFF || h.valueCount > 0x7FFFFFFE) return false;
+
+		alphabet = static_cast<const uint16_t*>(section(h.alphabetOffset, h.alphabetUnits, 2));
+		baseArr = static_cast<const int32_t*>(section(h.baseOffset, h.nodeCount, 4));
+		checkArr = static_cast<const int32_t*>(section(h.checkOffset, h.nodeCount, 4));
+		valueArr = static_cast<const int32_t*>(section(h.valueOffset, h.nodeCount, 4));
+		textIndex = static_cast<const uint32_t*>(section(h.textIndexOffset, h.valueCount + 1, 4));
+		text = static_cast<const uint16_t*>(section(h.textOffset, h.unitCount, 2));
+		if (!alphabet || !baseArr || !checkArr || !valueArr || !textIndex || !text) return false;
+
+		// Transitions are bounds-checked as they're taken; values and the text
+		// index are checked once here.
+		for (uint32_t n = 0; n < h.nodeCount; ++n) {
+			if (valueArr[n] < -1 || valueArr[n] >= (int64_t)h.valueCount) return false;
+		}
+		if (textIndex[0] != 0 || textIndex[h.valueCount] != h.unitCount) return false;
+		for (uint32_t v = 0; v < h.valueCount; ++v) {
+			if (textIndex[v] > textIndex[v + 1]) return false;
+		}
+
+		alphabetUnits = h.alphabetUnits;
+		nodes = h.nodeCount;
+		return true;
+	}
+
+	const uint8_t* base = nullptr;
+	size_t length = 0;
+#ifdef _WIN32
+	HANDLE handle = nullptr;
+#endif
+
+	uint32_t alphabetUnits = 0;
+	uint32_t nodes = 0; // 0 = nothing loaded
+	const uint16_t* alphabet = nullptr;
+	const int32_t* baseArr = nullptr;
+	const int32_t* checkArr = nullptr;
+	const int32_t* valueArr = nullptr;
+	const uint32_t* textIndex = nullptr;
+	const uint16_t* text = nullptr;
+};
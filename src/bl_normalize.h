@@ -0,0 +1,560 @@
+// bl_normalize.h
+//
+// Hungarian text normalization ahead of the sanitizer: numbers (cardinals,
+// ordinals, decimals, dates) become words, common abbreviations are expanded
+// and a few symbols are read out, so tts.dll doesn't spell them. One pass over
+// the input into a caller-owned buffer whose capacity is reused across calls;
+// the word tables are static and the abbreviation trie is built once. Plain
+// C++17 like bl_ring.h, so the rules can be exercised away from tts.dll.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// What blNormalize touches (combine freely).
+static const unsigned kNormNumbers = 1;
+static const unsigned kNormAbbreviations = 2;
+static const unsigned kNormSymbols = 4;
+
+// ------------------------------------------------------------
+// Character classes (only what the rules below need)
+// ------------------------------------------------------------
+inline bool blIsDigit(wchar_t c) { return c >= L'0' && c <= L'9'; }
+
+inline bool blIsLetter(wchar_t c) {
+	return (c >= L'a' && c <= L'z') || (c >= L'A' && c <= L'Z') ||
+		(c >= 0xC0 && c <= 0x24F && c != 0xD7 && c != 0xF7);
+}
+
+inline bool blIsWordUnit(wchar_t c) { return blIsLetter(c) || blIsDigit(c); }
+
+inline bool blIsLowerHu(wchar_t c) {
+	switch (c) {
+	case 0xE1: case 0xE9: case 0xED: case 0xF3: case 0xF6: case 0x151: case 0xFA: case 0xFC: case 0x171: return true;
+	default: return c >= L'a' && c <= L'z';
+	}
+}
+
+inline wchar_t blToLowerHu(wchar_t c) {
+	if (c >= L'A' && c <= L'Z') return (wchar_t)(c + 32);
+	switch (c) {
+	case 0xC1: case 0xC9: case 0xCD: case 0xD3: case 0xD6: case 0xDA: case 0xDC: return (wchar_t)(c + 0x20);
+	case 0x150: case 0x170: return (wchar_t)(c + 1);
+	default: return c;
+	}
+}
+
+// ------------------------------------------------------------
+// Numerals
+// ------------------------------------------------------------
+static const wchar_t* const kHuOnes[10] = { L"", L"egy", L"kett\u0151", L"h\u00E1rom", L"n\u00E9gy", L"\u00F6t", L"hat", L"h\u00E9t", L"nyolc", L"kilenc" };
+static const wchar_t* const kHuTens[10] = { L"", L"t\u00EDz", L"h\u00FAsz", L"harminc", L"negyven", L"\u00F6tven", L"hatvan", L"hetven", L"nyolcvan", L"kilencven" };
+// Tens with units after them (tizenegy, huszonegy).
+static const wchar_t* const kHuTensPrefix[10] = { L"", L"tizen", L"huszon", L"harminc", L"negyven", L"\u00F6tven", L"hatvan", L"hetven", L"nyolcvan", L"kilencven" };
+// Ordinal endings of a compound (tizenegyedik, huszonkettedik); 1. and 2. on
+// their own are első and második.
+static const wchar_t* const kHuOrdOnes[10] = { L"", L"egyedik", L"kettedik", L"harmadik", L"negyedik", L"\u00F6t\u00F6dik", L"hatodik", L"hetedik", L"nyolcadik", L"kilencedik" };
+static const wchar_t* const kHuOrdTens[10] = { L"", L"tizedik", L"huszadik", L"harmincadik", L"negyvenedik", L"\u00F6tvenedik", L"hatvanadik", L"hetvenedik", L"nyolcvanadik", L"kilencvenedik" };
+static const wchar_t* const kHuScale[4] = { L"", L"ezer", L"milli\u00F3", L"milli\u00E1rd" };
+static const wchar_t* const kHuScaleOrd[4] = { L"", L"ezredik", L"milliomodik", L"milli\u00E1rdodik" };
+static const wchar_t* const kHuMonths[13] = { L"", L"janu\u00E1r", L"febru\u00E1r", L"m\u00E1rcius", L"\u00E1prilis", L"m\u00E1jus", L"j\u00FAnius",
+	L"j\u00FAlius", L"augusztus", L"szeptember", L"okt\u00F3ber", L"november", L"december" };
+
+// Largest number read as a whole; longer digit runs are read digit by digit.
+static const size_t kNormMaxDigits = 12;
+
+// One group of three digits (1-999). `last`: nothing follows, so a final 2 is
+// kettő rather than két. `ordinal`: the number ends in this group.
+inline void blAppendGroup(std::wstring& out, unsigned g, bool last, bool ordinal) {
+	const unsigned h = g / 100, t = (g / 10) % 10, o = g % 10;
+	if (h) {
+		if (h == 2) out += L"k\u00E9t";
+		else if (h > 2) out += kHuOnes[h];
+		out += L"sz\u00E1z";
+		if (t == 0 && o == 0) {
+			if (ordinal) out += L"adik";
+			return;
+		}
+	}
+	if (t) {
+		if (o == 0) {
+			out += ordinal ? kHuOrdTens[t] : kHuTens[t];
+			return;
+		}
+		out += kHuTensPrefix[t];
+	}
+	if (ordinal) out += kHuOrdOnes[o];
+	else out += (o == 2 && !last) ? L"k\u00E9t" : kHuOnes[o];
+}
+
+// n < 10^12. Groups above two thousand are spaced apart (kétezer huszonnégy),
+// which is how the engine phrases them best. `counting`: the number counts
+// the word after it, so a final 2 is két (tizenkét kilométer).
+inline void blAppendNumber(std::wstring& out, uint64_t n, bool ordinal, bool counting = false) {
+	if (n == 0) { out += ordinal ? L"nulladik" : L"nulla"; return; }
+	if (ordinal && n == 1) { out += L"els\u0151"; return; }
+	if (ordinal && n == 2) { out += L"m\u00E1sodik"; return; }
+
+	unsigned groups[4];
+	uint64_t rest = n;
+	for (int k = 0; k < 4; ++k) {
+		groups[k] = (unsigned)(rest % 1000);
+		rest /= 1000;
+	}
+	int lowest = 0;
+	while (groups[lowest] == 0) ++lowest;
+
+	bool first = true;
+	for (int k = 3; k >= 0; --k) {
+		const unsigned g = groups[k];
+		if (g == 0) continue;
+		if (!first && n > 2000) out += L' ';
+		first = false;
+
+		const bool end = (k == lowest);
+		if (k == 0) {
+			blAppendGroup(out, g, !counting, ordinal);
+		} else {
+			if (!(k == 1 && g == 1)) blAppendGroup(out, g, false, false); // ezer, not egyezer
+			out += (end && ordinal) ? kHuScaleOrd[k] : kHuScale[k];
+		}
+	}
+}
+
+// Day of the month as in dates: elseje, másodika, tizenötödike.
+inline void blAppendDay(std::wstring& out, unsigned d) {
+	if (d == 1) { out += L"elseje"; return; }
+	blAppendNumber(out, d, true);
+	// Every other ordinal ends in -dik; the vowel before it picks the suffix.
+	const wchar_t v = out[out.size() - 4];
+	out += (v == L'a' || v == L'o') ? L'a' : L'e';
+}
+
+inline void blAppendDigits(std::wstring& out, const wchar_t* p, size_t n) {
+	for (size_t k = 0; k < n; ++k) {
+		if (k) out += L' ';
+		out += (p[k] == L'0') ? L"nulla" : kHuOnes[p[k] - L'0'];
+	}
+}
+
+inline uint64_t blParseDigits(const wchar_t* p, size_t n) {
+	uint64_t v = 0;
+	for (size_t k = 0; k < n; ++k) v = v * 10 + (uint64_t)(p[k] - L'0');
+	return v;
+}
+
+// Digits at in[i] (up to len): how many, at most `max` (0 if none).
+inline size_t blDigitRun(const wchar_t* in, size_t i, size_t len, size_t max) {
+	size_t n = 0;
+	while (i + n < len && blIsDigit(in[i + n]) && n <= max) ++n;
+	return (n > max) ? 0 : n;
+}
+
+// Words that follow a standalone number rather than being counted by it
+// (kettő és három, tizenkettő után).
+static const wchar_t* const kHuAfterStandalone[] = {
+	L"\u00E9s", L"meg", L"vagy", L"is", L"sem", L"se", L"pedig", L"de", L"van", L"volt", L"lesz", L"lett",
+	L"ut\u00E1n", L"el\u0151tt", L"k\u00F6z\u00F6tt", L"\u00F3ta", L"alatt", L"felett", L"f\u00F6l\u00F6tt",
+	L"mellett", L"helyett", L"szerint", L"k\u00F6r\u00FCl", L"ellen", L"plusz", L"m\u00EDnusz", L"per",
+};
+
+// Does the number ending at in[k] count what comes next, so that it's két
+// rather than kettő? Yes before a unit or symbol (2 km, 2%, 2 Ft) and before
+// any other lowercase word except those above.
+inline bool blCountsNextWord(const wchar_t* in, size_t k, size_t len) {
+	if (k < len && (in[k] == L'%' || in[k] == 0xB0)) return true;
+	size_t w = k;
+	while (w < len && in[w] == L' ') ++w;
+	if (w == k || w >= len) return false;
+	const wchar_t c = in[w];
+	if (c == L'%' || c == 0xB0 || c == 0x20AC || c == L'$') return true;
+	if (c == L'F' && w + 1 < len && in[w + 1] == L't' && (w + 2 >= len || !blIsLetter(in[w + 2]))) return true;
+	if (!blIsLowerHu(c)) return false;
+
+	size_t e = w;
+	while (e < len && blIsLetter(in[e])) ++e;
+	for (const wchar_t* word : kHuAfterStandalone) {
+		size_t n = 0;
+		while (word[n] && w + n < e && in[w + n] == word[n]) ++n;
+		if (word[n] == 0 && w + n == e) return false;
+	}
+	return true;
+}
+
+// The number just written takes a suffix (5-ös, 2024-ben): join it the way
+// the words do, lengthening a final a and dropping the vowel some stems lose
+// before a vowel (kettes, hármas, hetes, tizes, ezres).
+inline void blJoinSuffix(std::wstring& out, wchar_t first) {
+	auto endsWith = [&](const wchar_t* w) {
+		size_t n = 0;
+		while (w[n]) ++n;
+		return out.size() >= n && out.compare(out.size() - n, n, w) == 0;
+	};
+	if (endsWith(L"nulla")) { out.back() = 0xE1; return; }
+	switch (first) {
+	case L'a': case L'e': case L'i': case L'o': case L'u': case 0xE1: case 0xE9: case 0xED:
+	case 0xF3: case 0xF6: case 0x151: case 0xFA: case 0xFC: case 0x171: break;
+	default: return;
+	}
+	if (endsWith(L"kett\u0151")) out.pop_back();
+	else if (endsWith(L"h\u00E1rom") || endsWith(L"ezer")) out.erase(out.size() - 2, 1);
+	else if (endsWith(L"h\u00E9t")) out[out.size() - 2] = L'e';
+	else if (endsWith(L"t\u00EDz")) out[out.size() - 2] = L'i';
+}
+
+// A '.' at in[dot] marks an ordinal (or ends a date) when a lowercase word
+// follows after whitespace; otherwise it's taken to end the sentence.
+inline bool blOrdinalDot(const wchar_t* in, size_t dot, size_t len) {
+	if (dot >= len || in[dot] != L'.') return false;
+	size_t k = dot + 1;
+	if (k >= len || in[k] != L' ') return false;
+	while (k < len && in[k] == L' ') ++k;
+	return k < len && blIsLowerHu(in[k]);
+}
+
+// Month named at in[k] (lowercase, whole word): 1-12, or 0.
+inline unsigned blMonthAt(const wchar_t* in, size_t k, size_t len, size_t* end) {
+	for (unsigned m = 1; m <= 12; ++m) {
+		size_t n = 0;
+		const wchar_t* name = kHuMonths[m];
+		while (name[n] && k + n < len && in[k + n] == name[n]) ++n;
+		if (name[n] == 0 && (k + n >= len || !blIsLetter(in[k + n]))) {
+			*end = k + n;
+			return m;
+		}
+	}
+	return 0;
+}
+
+// YYYY. MM. DD. (spaces optional), YYYY. <month> D. or YYYY-MM-DD at in[i].
+// On a match, writes the date and returns the units consumed; else 0.
+inline size_t blTryDate(const wchar_t* in, size_t i, size_t len, std::wstring& out) {
+	if (blDigitRun(in, i, len, 4) != 4) return 0;
+	size_t k = i + 4;
+	if (k >= len) return 0;
+	const wchar_t sep = in[k];
+	if (sep != L'.' && sep != L'-') return 0;
+
+	// 2023. december 1.
+	if (sep == L'.' && k + 1 < len && in[k + 1] == L' ') {
+		size_t m = k + 1;
+		while (m < len && in[m] == L' ') ++m;
+		size_t afterMonth = 0;
+		const unsigned month = blMonthAt(in, m, len, &afterMonth);
+		if (month) {
+			size_t d = afterMonth;
+			while (d < len && in[d] == L' ') ++d;
+			const size_t n = blDigitRun(in, d, len, 2);
+			const unsigned day = n ? (unsigned)blParseDigits(in + d, n) : 0;
+			if (day >= 1 && day <= 31 && d + n < len && in[d + n] == L'.') {
+				blAppendNumber(out, blParseDigits(in + i, 4), false);
+				out += L' ';
+				out += kHuMonths[month];
+				out += L' ';
+				blAppendDay(out, day);
+				return d + n + (blOrdinalDot(in, d + n, len) ? 1 : 0) - i;
+			}
+		}
+	}
+
+	auto field = [&](size_t& pos, unsigned& value) -> bool {
+		if (sep == L'.') while (pos < len && in[pos] == L' ') ++pos;
+		const size_t n = blDigitRun(in, pos, len, 2);
+		if (n == 0 || (sep == L'-' && n != 2)) return false;
+		value = (unsigned)blParseDigits(in + pos, n);
+		pos += n;
+		return true;
+	};
+
+	unsigned month = 0, day = 0;
+	++k;
+	if (!field(k, month) || k >= len || in[k] != sep) return 0;
+	++k;
+	if (!field(k, day)) return 0;
+	if (month < 1 || month > 12 || day < 1 || day > 31) return 0;
+	if (k < len && blIsDigit(in[k])) return 0;
+
+	blAppendNumber(out, blParseDigits(in + i, 4), false);
+	out += L' ';
+	out += kHuMonths[month];
+	out += L' ';
+	blAppendDay(out, day);
+	if (sep == L'.' && blOrdinalDot(in, k, len)) ++k; // the date's closing dot
+	return k - i;
+}
+
+// Number starting at in[i] (a digit). Writes it and returns units consumed.
+inline size_t blNormalizeNumber(const wchar_t* in, size_t i, size_t len, std::wstring& out) {
+	if (const size_t n = blTryDate(in, i, len, out)) return n;
+
+	size_t k = i;
+	while (k < len && blIsDigit(in[k])) ++k;
+	const size_t digits = k - i;
+
+	// Codes, phone numbers and the like: digit by digit.
+	if ((digits > 1 && in[i] == L'0') || digits > kNormMaxDigits) {
+		blAppendDigits(out, in + i, digits);
+		return digits;
+	}
+
+	uint64_t value = blParseDigits(in + i, digits);
+
+	// 1.000.000: groups of exactly three after dots. The whole run is sized up
+	// first: past kNormMaxDigits all of it is read digit by digit, rather than
+	// the groups that don't fit being left over as a second number.
+	if (digits <= 3) {
+		size_t runEnd = k;
+		size_t runDigits = digits;
+		while (runEnd + 4 <= len && in[runEnd] == L'.' && blDigitRun(in, runEnd + 1, len, 3) == 3) {
+			runDigits += 3;
+			runEnd += 4;
+		}
+		if (runDigits > kNormMaxDigits) {
+			blAppendDigits(out, in + i, digits);
+			for (; k < runEnd; k += 4) {
+				out += L' ';
+				blAppendDigits(out, in + k + 1, 3);
+			}
+			return runEnd - i;
+		}
+		for (; k < runEnd; k += 4) value = value * 1000 + blParseDigits(in + k + 1, 3);
+	}
+
+	// 3,14 and 12.5: decimal comma, or a lone decimal point (not a group of
+	// three, and not one of several dots as in 1.2.3), read as
+	// tenths/hundredths/thousandths.
+	bool decimal = k + 1 < len && in[k] == L',' && blIsDigit(in[k + 1]);
+	const bool afterDot = i >= 2 && in[i - 1] == L'.' && blIsDigit(in[i - 2]);
+	if (!decimal && !afterDot && k == i + digits && k + 1 < len && in[k] == L'.' && blIsDigit(in[k + 1])) {
+		size_t f = k + 1;
+		while (f < len && blIsDigit(in[f])) ++f;
+		decimal = !(f + 1 < len && in[f] == L'.' && blIsDigit(in[f + 1]));
+	}
+	if (decimal) {
+		size_t f = k + 1;
+		while (f < len && blIsDigit(in[f])) ++f;
+		const size_t fd = f - (k + 1);
+		// Két egész öt tized: both parts count what follows them.
+		blAppendNumber(out, value, false, true);
+		out += L" eg\u00E9sz ";
+		if (fd <= 3) {
+			static const wchar_t* const kFrac[4] = { L"", L" tized", L" sz\u00E1zad", L" ezred" };
+			blAppendNumber(out, blParseDigits(in + k + 1, fd), false, true);
+			out += kFrac[fd];
+		} else {
+			blAppendDigits(out, in + k + 1, fd);
+		}
+		return f - i;
+	}
+
+	if (blOrdinalDot(in, k, len)) {
+		blAppendNumber(out, value, true);
+		return k + 1 - i;
+	}
+
+	// 5-ös, 2024-ben: the suffix joins the number.
+	if (k + 1 < len && in[k] == L'-' && blIsLetter(in[k + 1])) {
+		blAppendNumber(out, value, false);
+		blJoinSuffix(out, in[k + 1]);
+		return k + 1 - i;
+	}
+
+	// 2-5 km: the first number of a range counts what the second one does.
+	size_t countsFrom = k;
+	if (k + 1 < len && in[k] == L'-' && blIsDigit(in[k + 1])) {
+		countsFrom = k + 1;
+		while (countsFrom < len && blIsDigit(in[countsFrom])) ++countsFrom;
+	}
+	blAppendNumber(out, value, false, blCountsNextWord(in, countsFrom, len));
+	return k - i;
+}
+
+// ------------------------------------------------------------
+// Abbreviations
+// ------------------------------------------------------------
+struct BlAbbrev {
+	const wchar_t* key; // lowercase; a capitalized first letter matches too
+	const wchar_t* expansion;
+	bool title;         // comes before a name, so its dot never ends a sentence
+};
+
+static const BlAbbrev kHuAbbrevs[] = {
+	{ L"pl.", L"p\u00E9ld\u00E1ul", false },
+	{ L"stb.", L"sat\u00F6bbi", false },
+	{ L"kb.", L"k\u00F6r\u00FClbel\u00FCl", false },
+	{ L"ill.", L"illetve", false },
+	{ L"\u00FAn.", L"\u00FAgynevezett", false },
+	{ L"ld.", L"l\u00E1sd", false },
+	{ L"v\u00F6.", L"vesd \u00F6ssze", false },
+	{ L"\u00E1lt.", L"\u00E1ltal\u00E1ban", false },
+	{ L"dr.", L"doktor", true },
+	{ L"id.", L"id\u0151sebb", true },
+	{ L"ifj.", L"ifjabb", true },
+	{ L"krt.", L"k\u00F6r\u00FAt", false },
+	{ L"tel.", L"telefon", false },
+	{ L"ford.", L"ford\u00EDtotta", false },
+	{ L"szerk.", L"szerkesztette", false },
+	{ L"\u00E9vf.", L"\u00E9vfolyam", false },
+	{ L"bp.", L"Budapest", false },
+	{ L"kft.", L"k\u00E1eft\u00E9", false },
+	{ L"bt.", L"b\u00E9t\u00E9", false },
+	{ L"zrt.", L"z\u00E9ert\u00E9", false },
+	{ L"nyrt.", L"nyeret\u00E9", false },
+	{ L"jan.", L"janu\u00E1r", false },
+	{ L"febr.", L"febru\u00E1r", false },
+	{ L"m\u00E1rc.", L"m\u00E1rcius", false },
+	{ L"\u00E1pr.", L"\u00E1prilis", false },
+	{ L"j\u00FAn.", L"j\u00FAnius", false },
+	{ L"j\u00FAl.", L"j\u00FAlius", false },
+	{ L"aug.", L"augusztus", false },
+	{ L"szept.", L"szeptember", false },
+	{ L"okt.", L"okt\u00F3ber", false },
+	{ L"nov.", L"november", false },
+	{ L"dec.", L"december", false },
+	{ L"db", L"darab", false },
+	{ L"ft", L"forint", false },
+	{ L"km", L"kilom\u00E9ter", false },
+	{ L"kg", L"kilogramm", false },
+	{ L"cm", L"centim\u00E9ter", false },
+	{ L"mm", L"millim\u00E9ter", false },
+};
+
+// Character trie over kHuAbbrevs, built once. Children are a linked list per
+// node; the keys are short, so that beats a table per node.
+class BlAbbrevTrie {
+public:
+	static const BlAbbrevTrie& get() {
+		static const BlAbbrevTrie trie;
+		return trie;
+	}
+
+	// Longest abbreviation at in[i] that ends at a word boundary (or with its
+	// own dot). Returns its kHuAbbrevs index and sets *end, or -1.
+	int match(const wchar_t* in, size_t i, size_t len, size_t* end) const {
+		int node = 0;
+		int best = -1;
+		for (size_t k = i; k < len; ++k) {
+			const wchar_t ch = (k == i) ? blToLowerHu(in[k]) : in[k];
+			node = child(node, ch);
+			if (node < 0) break;
+			const int v = nodes[node].value;
+			if (v >= 0 && (ch == L'.' || k + 1 >= len || !blIsWordUnit(in[k + 1]))) {
+				best = v;
+				*end = k + 1;
+			}
+		}
+		return best;
+	}
+
+private:
+	struct Node {
+		wchar_t ch;
+		int firstChild;
+		int next;
+		int value;
+	};
+
+	BlAbbrevTrie() {
+		nodes.push_back({ 0, -1, -1, -1 });
+		for (size_t a = 0; a < sizeof(kHuAbbrevs) / sizeof(kHuAbbrevs[0]); ++a) {
+			int node = 0;
+			for (const wchar_t* p = kHuAbbrevs[a].key; *p; ++p) {
+				int c = child(node, *p);
+				if (c < 0) {
+					c = (int)nodes.size();
+					nodes.push_back({ *p, -1, nodes[node].firstChild, -1 });
+					nodes[node].firstChild = c;
+				}
+				node = c;
+			}
+			nodes[node].value = (int)a;
+		}
+	}
+
+	int child(int node, wchar_t ch) const {
+		for (int c = nodes[node].firstChild; c >= 0; c = nodes[c].next) {
+			if (nodes[c].ch == ch) return c;
+		}
+		return -1;
+	}
+
+	std::vector<Node> nodes;
+};
+
+// ------------------------------------------------------------
+// Symbols
+// ------------------------------------------------------------
+inline const wchar_t* blSymbolWord(wchar_t c) {
+	switch (c) {
+	case L'%': return L" sz\u00E1zal\u00E9k ";
+	case L'&': return L" \u00E9s ";
+	case L'+': return L" plusz ";
+	case L'=': return L" egyenl\u0151 ";
+	case L'<': return L" kisebb ";
+	case L'>': return L" nagyobb ";
+	case L'@': return L" kukac ";
+	case 0xA7: return L" paragrafus "; // §
+	case 0xB0: return L" fok ";        // °
+	case 0x20AC: return L" eur\u00F3 ";
+	case L'$': return L" doll\u00E1r ";
+	default: return nullptr;
+	}
+}
+
+// ------------------------------------------------------------
+// Driver
+// ------------------------------------------------------------
+// Normalize `len` units of `in` into `out` (cleared first; its capacity is
+// kept, so a buffer reused across calls stops allocating once it's warm).
+inline void blNormalize(const wchar_t* in, size_t len, unsigned flags, std::wstring& out) {
+	out.clear();
+	if (out.capacity() < len + len / 2) out.reserve(len + len / 2);
+
+	const BlAbbrevTrie* abbrevs = (flags & kNormAbbreviations) ? &BlAbbrevTrie::get() : nullptr;
+	size_t i = 0;
+	while (i < len) {
+		const wchar_t c = in[i];
+		const bool wordStart = (i == 0 || !blIsWordUnit(in[i - 1]));
+
+		if ((flags & kNormNumbers) && wordStart && blIsDigit(c)) {
+			i += blNormalizeNumber(in, i, len, out);
+			continue;
+		}
+		// -5 (but not the hyphen in 10-20)
+		if ((flags & kNormNumbers) && c == L'-' && i + 1 < len && blIsDigit(in[i + 1]) &&
+			(i == 0 || in[i - 1] == L' ' || in[i - 1] == L'(')) {
+			out += L"m\u00EDnusz ";
+			++i;
+			i += blNormalizeNumber(in, i, len, out);
+			continue;
+		}
+		if (abbrevs && wordStart && blIsLetter(c)) {
+			size_t end = 0;
+			const int a = abbrevs->match(in, i, len, &end);
+			if (a >= 0) {
+				out += kHuAbbrevs[a].expansion;
+				if (in[end - 1] == L'.') {
+					// Its dot may have ended the sentence too.
+					size_t k = end;
+					while (k < len && in[k] == L' ') ++k;
+					if (!kHuAbbrevs[a].title && (k >= len || (blIsLetter(in[k]) && blToLowerHu(in[k]) != in[k]))) out += L'.';
+				} else if (end + 1 < len && in[end] == L'-' && blIsLetter(in[end + 1])) {
+					++end; // km-re: the suffix joins the word
+				}
+				i = end;
+				continue;
+			}
+		}
+		if (flags & kNormSymbols) {
+			if (const wchar_t* w = blSymbolWord(c)) {
+				out += w;
+				++i;
+				continue;
+			}
+		}
+		out += c;
+		++i;
+	}
+}
@@ -0,0 +1,71 @@
+// bl_pool.h
+//
+// Reusable fixed-size audio blocks for the capture path. Like bl_ring.h this
+// is plain C++17 with no Windows dependencies.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bl_ring.h"
+
+// Blocks are carved out of a few large slabs and recycled through an SPSC ring
+// of free pointers, so taking and returning a block never touches the heap.
+//
+// take() belongs to the producer side (the thread filling blocks) and give()
+// to the consumer side (the thread draining them). grow() adds blocks by
+// giving them, so it must be serialized with give(). blockCount() may be read
+// from either side.
+class AudioBlockPool {
+public:
+	static const size_t blockBytes = 2048;
+
+	explicit AudioBlockPool(size_t maxBlocks) : freeBlocks(maxBlocks) {}
+
+	AudioBlockPool(const AudioBlockPool&) = delete;
+	AudioBlockPool& operator=(const AudioBlockPool&) = delete;
+
+	// Producer: a free block, or nullptr if every block is in use.
+	uint8_t* take() {
+		uint8_t** p = freeBlocks.front();
+		if (!p) return nullptr;
+		uint8_t* block = *p;
+		freeBlocks.pop();
+		return block;
+	}
+
+	// Consumer: hand a block from take() back.
+	void give(uint8_t* block) {
+		if (!block) return;
+		uint8_t** p = freeBlocks.pushSlot();
+		if (!p) return; // can't happen: the free ring holds every block there is
+		*p = block;
+		freeBlocks.commitPush();
+	}
+
+	// Consumer side: make sure at least `blocks` blocks exist (grow-only).
+	// This is the only place that allocates.
+	void grow(size_t blocks) {
+		if (blocks > freeBlocks.capacity()) blocks = freeBlocks.capacity();
+		const size_t have = total.load(std::memory_order_relaxed);
+		if (blocks <= have) return;
+
+		const size_t add = blocks - have;
+		std::unique_ptr<uint8_t[]> slab(new uint8_t[add * blockBytes]);
+		for (size_t i = 0; i < add; ++i) give(slab.get() + i * blockBytes);
+		slabs.push_back(std::move(slab));
+		total.store(blocks, std::memory_order_release);
+	}
+
+	size_t blockCount() const { return total.load(std::memory_order_acquire); }
+	// Blocks take() can still hand out (exact on the producer side).
+	size_t freeCount() const { return freeBlocks.size(); }
+
+private:
+	SpscRing<uint8_t*> freeBlocks;
+	std::vector<std::unique_ptr<uint8_t[]>> slabs;
+	std::atomic<size_t> total{ 0 };
+};
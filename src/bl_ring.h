@@ -0,0 +1,88 @@
+// bl_ring.h
+//
+// Lock-free single-producer / single-consumer ring used for the wrapper's
+// output stream. No Windows headers on purpose: the queue core builds with
+// any C++17 compiler, so it can be exercised away from tts.dll.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity ring of preconstructed slots.
+//
+// Producer side:  T* slot = ring.pushSlot(); fill *slot; ring.commitPush();
+// Consumer side:  T* slot = ring.front();    read *slot; ring.pop();
+//
+// Exactly one thread may act as producer and one as consumer at a time;
+// callers that have several producers (or consumers) must serialize them
+// among themselves. The two sides never wait on each other.
+template <typename T>
+class SpscRing {
+public:
+	explicit SpscRing(size_t minCapacity) {
+		size_t cap = 2;
+		while (cap < minCapacity) cap <<= 1;
+		slots.resize(cap);
+		mask = cap - 1;
+	}
+
+	SpscRing(const SpscRing&) = delete;
+	SpscRing& operator=(const SpscRing&) = delete;
+
+	size_t capacity() const { return mask + 1; }
+
+	// Approximate when called from a third thread; exact from either side.
+	size_t size() const {
+		const size_t t = tail.load(std::memory_order_acquire);
+		const size_t h = head.load(std::memory_order_acquire);
+		return t - h;
+	}
+
+	bool empty() const { return size() == 0; }
+
+	// Producer: next free slot, or nullptr if the ring is full.
+	T* pushSlot() {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		const size_t h = head.load(std::memory_order_acquire);
+		if (t - h > mask) return nullptr;
+		return &slots[t & mask];
+	}
+
+	// Producer: publish the slot returned by pushSlot().
+	void commitPush() {
+		const size_t t = tail.load(std::memory_order_relaxed);
+		tail.store(t + 1, std::memory_order_release);
+	}
+
+	// Consumer: oldest published slot, or nullptr if the ring is empty.
+	T* front() {
+		const size_t h = head.load(std::memory_order_relaxed);
+		const size_t t = tail.load(std::memory_order_acquire);
+		if (h == t) return nullptr;
+		return &slots[h & mask];
+	}
+
+	// Consumer: the published slot `i` places behind the front (0 = front),
+	// or nullptr if fewer are queued.
+	T* peek(size_t i) {
+		const size_t h = head.load(std::memory_order_relaxed);
+		const size_t t = tail.load(std::memory_order_acquire);
+		if (t - h <= i) return nullptr;
+		return &slots[(h + i) & mask];
+	}
+
+	// Consumer: hand the front slot back to the producer.
+	void pop() {
+		const size_t h = head.load(std::memory_order_relaxed);
+		head.store(h + 1, std::memory_order_release);
+	}
+
+private:
+	// Producer and consumer indices live on separate cache lines so the two
+	// threads don't false-share.
+	alignas(64) std::atomic<size_t> head{ 0 };
+	alignas(64) std::atomic<size_t> tail{ 0 };
+	alignas(64) std::vector<T> slots;
+	size_t mask = 0;
+};
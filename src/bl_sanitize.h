@@ -0,0 +1,87 @@
+// bl_sanitize.h
+//
+// Text cleanup before StartSay: keep what code page 1250 can carry, turn
+// everything else (controls, NBSP, '?', unmappable characters) into spaces
+// and collapse those. Plain C++17 over the generated table, so it can be
+// checked against the old WideCharToMultiByte round trip on any platform.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BL_SANITIZE_SSE2 1
+#endif
+
+#include "bl_cp1250_table.h"
+
+// What one UTF-16 code unit becomes. Anything past the BMP (only possible
+// where wchar_t is 32 bits) is unmappable, like a surrogate on Windows.
+inline uint32_t blSafeUnit(uint32_t u) {
+	if (u > 0xFFFF) return 0x20;
+	return kCp1250Pages[kCp1250PageIndex[u >> 8]][u & 0xFF];
+}
+
+#ifdef BL_SANITIZE_SSE2
+// 8 units at `in` that are all printable ASCII other than '?', with no two
+// spaces in a row (counting the last unit already written): the table would
+// leave them as they are and the collapse wouldn't touch them, so they can be
+// copied as-is. Returns false for anything else.
+inline bool blCopyPlainBlock(const uint16_t* in, uint16_t* out, bool& prevSpace) {
+	const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+	// Signed compares: units >= 0x8000 look negative and fail the lower bound.
+	const __m128i printable = _mm_and_si128(
+		_mm_cmpgt_epi16(v, _mm_set1_epi16(0x1F)),
+		_mm_cmplt_epi16(v, _mm_set1_epi16(0x7F)));
+	const __m128i plain = _mm_andnot_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16(0x3F)), printable);
+	if (_mm_movemask_epi8(plain) != 0xFFFF) return false;
+
+	const __m128i space = _mm_cmpeq_epi16(v, _mm_set1_epi16(0x20));
+	const unsigned spaces = (unsigned)_mm_movemask_epi8(_mm_packs_epi16(space, space)) & 0xFFu;
+	if (spaces & ((spaces << 1) | (prevSpace ? 1u : 0u))) return false;
+
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(out), v);
+	prevSpace = (spaces & 0x80u) != 0;
+	return true;
+}
+#endif
+
+// Single pass over `len` units of `in`: map, then collapse runs of spaces to
+// one, with none leading or trailing. `out` needs room for `len` units;
+// nothing is allocated. Returns the units written. Where the unit type is 16
+// bits and SSE2 is there, plain ASCII goes through 8 units at a time and only
+// the blocks with something to change take the table path.
+template <typename Ch>
+size_t blSanitizeInto(const Ch* in, size_t len, Ch* out) {
+	size_t n = 0;
+	size_t i = 0;
+	bool prevSpace = true;
+
+	while (i < len) {
+#ifdef BL_SANITIZE_SSE2
+		if (sizeof(Ch) == 2 && len - i >= 8 &&
+			blCopyPlainBlock(reinterpret_cast<const uint16_t*>(in + i), reinterpret_cast<uint16_t*>(out + n), prevSpace)) {
+			i += 8;
+			n += 8;
+			continue;
+		}
+		// Table path for this block (or the short tail), then try SIMD again.
+		const size_t end = (len - i >= 8) ? i + 8 : len;
+#else
+		const size_t end = len;
+#endif
+		for (; i < end; ++i) {
+			const uint32_t ch = blSafeUnit((uint32_t)in[i]);
+			if (ch == 0x20) {
+				if (!prevSpace) out[n++] = (Ch)0x20;
+				prevSpace = true;
+			} else {
+				out[n++] = (Ch)ch;
+				prevSpace = false;
+			}
+		}
+	}
+	if (n > 0 && out[n - 1] == (Ch)0x20) --n;
+	return n;
+}
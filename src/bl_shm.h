@@ -0,0 +1,423 @@
+// bl_shm.h
+//
+// Named shared-memory ring carrying the wrapper's output stream (audio and
+// markers) to a reader in another process, e.g. across the 32/64-bit NVDA
+// bridge. Backed by a Win32 file mapping or POSIX shm, picked at compile
+// time; everything else is plain C++17, so both ends can be exercised on
+// Linux.
+//
+// Layout (all little-endian, identical for 32- and 64-bit processes):
+//   [0, 256)         BlShmHeader
+//   [256, 256+cap)   data ring of records, cap a power of two
+// A record is a 16-byte BlShmRecord followed by `len` payload bytes, padded
+// to 16. Records never wrap: a writer that hits the end of the ring writes a
+// BL_SHM_PAD record there and starts over at offset 0. writePos/readPos are
+// free-running byte counters.
+//
+// Neither end polls: a reader with nothing to read waits on dataSeq, a
+// writer short of room on spaceSeq, through BlShmSignal (a futex on Linux, a
+// named event on Windows).
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+static const uint32_t BL_SHM_MAGIC = 0x48534C42u; // "BLSH"
+static const uint32_t BL_SHM_VERSION = 2;
+static const uint32_t BL_SHM_HEADER_BYTES = 256;
+static const uint32_t BL_SHM_PAD = 0xFFFFFFFFu;  // record type: skip to offset 0
+
+struct BlShmHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t capacity;     // data ring bytes
+	uint32_t headerBytes;  // offset of the data ring
+	alignas(64) std::atomic<uint32_t> writePos;  // producer
+	std::atomic<uint32_t> dataSeq;       // producer: bumped per record written
+	std::atomic<uint32_t> spaceWaiters;  // producer: waiting for room
+	alignas(64) std::atomic<uint32_t> readPos;   // consumer
+	std::atomic<uint32_t> spaceSeq;      // consumer: bumped per record consumed
+	std::atomic<uint32_t> dataWaiters;   // consumer: waiting for records
+	// Bumped by the producer on bl_stop(); records stamped with an older epoch
+	// are skipped by the reader, so a stop invalidates the ring in O(1).
+	alignas(64) std::atomic<uint32_t> epoch;
+	std::atomic<uint32_t> droppedRecords;  // gave up waiting for the reader
+};
+
+struct BlShmRecord {
+	uint32_t type;   // BL_ITEM_* or BL_SHM_PAD
+	int32_t value;   // as bl_read() reports it
+	uint32_t epoch;
+	uint32_t len;    // payload bytes (audio only)
+};
+
+static_assert(sizeof(BlShmHeader) <= BL_SHM_HEADER_BYTES, "shm header outgrew its slot");
+static_assert(sizeof(BlShmRecord) == 16, "shm record layout is shared across processes");
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "shm counters must be lock-free");
+
+// One mapping of a named region. The creator owns the name (POSIX unlinks it
+// on close); openers only map it. A POSIX name outlives a creator that died
+// without closing, so creating over one unlinks it and starts afresh; on
+// Windows the name goes with its last handle and a clash is a live ring.
+class SharedMemoryRegion {
+public:
+	SharedMemoryRegion() = default;
+	~SharedMemoryRegion() { close(); }
+
+	SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+	SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+	bool create(const char* name, size_t bytes) { return map(name, bytes, true); }
+	bool open(const char* name) { return map(name, 0, false); }
+
+	uint8_t* data() const { return base; }
+	size_t size() const { return length; }
+
+	void close() {
+#ifdef _WIN32
+		if (base) UnmapViewOfFile(base);
+		if (handle) CloseHandle(handle);
+		handle = nullptr;
+#else
+		if (base) munmap(base, length);
+		if (owner && !shmName.empty()) shm_unlink(shmName.c_str());
+#endif
+		base = nullptr;
+		length = 0;
+		owner = false;
+		shmName.clear();
+	}
+
+private:
+	bool map(const char* name, size_t bytes, bool creating) {
+		close();
+		if (!name || !*name) return false;
+#ifdef _WIN32
+		if (creating) {
+			handle = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+				(DWORD)((uint64_t)bytes >> 32), (DWORD)bytes, name);
+			// Someone else's ring under our name: don't scribble over it.
+			if (handle && GetLastError() == ERROR_ALREADY_EXISTS) { CloseHandle(handle); handle = nullptr; }
+		} else {
+			handle = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name);
+		}
+		if (!handle) return false;
+		base = static_cast<uint8_t*>(MapViewOfFile(handle, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+		if (!base) { close(); return false; }
+		MEMORY_BASIC_INFORMATION mbi = {};
+		VirtualQuery(base, &mbi, sizeof(mbi));
+		length = creating ? bytes : (size_t)mbi.RegionSize;
+#else
+		// POSIX names are "/name"; accept either form.
+		shmName = (name[0] == '/') ? name : std::string("/") + name;
+		int fd = creating
+			? shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600)
+			: shm_open(shmName.c_str(), O_RDWR, 0);
+		if (fd < 0 && creating && errno == EEXIST) {
+			// Left behind by a crashed host; a reader still mapping it keeps its
+			// own copy and sees no new records.
+			shm_unlink(shmName.c_str());
+			fd = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+		}
+		if (fd < 0) { shmName.clear(); return false; }
+		owner = creating;
+		if (creating) {
+			if (ftruncate(fd, (off_t)bytes) != 0) { ::close(fd); close(); return false; }
+			length = bytes;
+		} else {
+			struct stat st;
+			if (fstat(fd, &st) != 0) { ::close(fd); close(); return false; }
+			length = (size_t)st.st_size;
+		}
+		void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (p == MAP_FAILED) { length = 0; close(); return false; }
+		base = static_cast<uint8_t*>(p);
+#endif
+		return true;
+	}
+
+	uint8_t* base = nullptr;
+	size_t length = 0;
+	bool owner = false;
+	std::string shmName;
+#ifdef _WIN32
+	HANDLE handle = nullptr;
+#endif
+};
+
+// One end's wakeup: a sequence word in the header, bumped by notify(), and a
+// count of waiters so notify() only makes a system call when someone sleeps.
+// On Linux the word itself is the futex; on Windows a named auto-reset event
+// ("<ring name><suffix>") carries the wakeup across processes. Elsewhere a
+// wait just sleeps a millisecond. Waiters always re-check their condition,
+// so a spurious or stale wakeup costs nothing.
+class BlShmSignal {
+public:
+	BlShmSignal() = default;
+	~BlShmSignal() { close(); }
+
+	BlShmSignal(const BlShmSignal&) = delete;
+	BlShmSignal& operator=(const BlShmSignal&) = delete;
+
+	bool open(const char* ringName, const char* suffix, std::atomic<uint32_t>* seqWord, std::atomic<uint32_t>* waiterCount, bool creating) {
+		close();
+		seq = seqWord;
+		waiters = waiterCount;
+#ifdef _WIN32
+		const std::string name = std::string(ringName) + suffix;
+		event = creating ? CreateEventA(nullptr, FALSE, FALSE, name.c_str())
+			: OpenEventA(EVENT_MODIFY_STATE | SYNCHRONIZE, FALSE, name.c_str());
+		return event != nullptr;
+#else
+		(void)ringName;
+		(void)suffix;
+		(void)creating;
+		return true;
+#endif
+	}
+
+	void close() {
+#ifdef _WIN32
+		if (event) CloseHandle(event);
+		event = nullptr;
+#endif
+		seq = nullptr;
+		waiters = nullptr;
+	}
+
+	// Take this before checking the condition, then wait(seen) if it failed.
+	uint32_t current() const { return seq->load(std::memory_order_seq_cst); }
+
+	// Returns once notify() has run since current() gave `seen`, or after
+	// timeoutMs, whichever is first.
+	void wait(uint32_t seen, uint32_t timeoutMs) {
+		waiters->fetch_add(1, std::memory_order_seq_cst);
+		if (seq->load(std::memory_order_seq_cst) == seen) {
+#ifdef _WIN32
+			WaitForSingleObject(event, timeoutMs);
+#elif defined(__linux__)
+			// Not FUTEX_PRIVATE_FLAG: the word is shared between processes.
+			struct timespec ts = { (time_t)(timeoutMs / 1000), (long)(timeoutMs % 1000) * 1000000L };
+			syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAIT, seen, &ts, nullptr, 0);
+#else
+			usleep((timeoutMs < 1) ? timeoutMs * 1000 : 1000);
+#endif
+		}
+		waiters->fetch_sub(1, std::memory_order_seq_cst);
+	}
+
+	void notify() {
+		seq->fetch_add(1, std::memory_order_seq_cst);
+		if (waiters->load(std::memory_order_seq_cst) == 0) return;
+#ifdef _WIN32
+		SetEvent(event);
+#elif defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(seq), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+	}
+
+private:
+	std::atomic<uint32_t>* seq = nullptr;
+	std::atomic<uint32_t>* waiters = nullptr;
+#ifdef _WIN32
+	HANDLE event = nullptr;
+#endif
+};
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words are plain 32-bit");
+
+// Event name suffixes for the two signals (Windows only: the mapping itself
+// holds the ring's own name in the same namespace).
+static const char* const BL_SHM_DATA_EVENT = ".data";
+static const char* const BL_SHM_SPACE_EVENT = ".space";
+
+// Producer end. Single writer; write() never blocks and returns false when
+// the reader is too far behind. To wait for room, take spaceSeq() before the
+// write() and pass it to waitForSpace() if that failed. Records carry the
+// epoch taken by the last stampEpoch() (the first epoch until then).
+class BlShmWriter {
+public:
+	bool create(const char* name, uint32_t minCapacity) {
+		// Room for at least a few full audio blocks, whatever was asked for.
+		uint32_t cap = 64 * 1024;
+		while (cap < minCapacity && cap < (1u << 30)) cap <<= 1;
+		if (!region.create(name, (size_t)BL_SHM_HEADER_BYTES + cap)) return false;
+
+		hdr = new (region.data()) BlShmHeader();
+		hdr->capacity = cap;
+		hdr->headerBytes = BL_SHM_HEADER_BYTES;
+		hdr->writePos.store(0, std::memory_order_relaxed);
+		hdr->readPos.store(0, std::memory_order_relaxed);
+		hdr->epoch.store(1, std::memory_order_relaxed);
+		stamp = 1;
+		hdr->droppedRecords.store(0, std::memory_order_relaxed);
+		hdr->dataSeq.store(0, std::memory_order_relaxed);
+		hdr->spaceWaiters.store(0, std::memory_order_relaxed);
+		hdr->spaceSeq.store(0, std::memory_order_relaxed);
+		hdr->dataWaiters.store(0, std::memory_order_relaxed);
+		if (!data.open(name, BL_SHM_DATA_EVENT, &hdr->dataSeq, &hdr->dataWaiters, true) ||
+			!space.open(name, BL_SHM_SPACE_EVENT, &hdr->spaceSeq, &hdr->spaceWaiters, true)) {
+			data.close();
+			region.close();
+			hdr = nullptr;
+			return false;
+		}
+		hdr->version = BL_SHM_VERSION;
+		// Readers check the magic last.
+		std::atomic_thread_fence(std::memory_order_release);
+		hdr->magic = BL_SHM_MAGIC;
+		return true;
+	}
+
+	bool write(uint32_t type, int32_t value, const void* payload, uint32_t len) {
+		const uint32_t cap = hdr->capacity;
+		const uint32_t need = recordBytes(len);
+		if (need > cap / 2) return false; // would never fit alongside a pad
+
+		uint32_t w = hdr->writePos.load(std::memory_order_relaxed);
+		const uint32_t r = hdr->readPos.load(std::memory_order_acquire);
+		const uint32_t off = w & (cap - 1);
+		const uint32_t tail = cap - off;
+		const uint32_t skip = (tail < need) ? tail : 0;
+		if ((w - r) + skip + need > cap) return false;
+
+		uint8_t* ring = region.data() + BL_SHM_HEADER_BYTES;
+		if (skip) {
+			// Everything is 16-aligned, so there is always room for the pad.
+			BlShmRecord pad = { BL_SHM_PAD, 0, 0, 0 };
+			std::memcpy(ring + off, &pad, sizeof(pad));
+			w += skip;
+		}
+
+		BlShmRecord rec = { type, value, stamp, len };
+		uint8_t* dst = ring + (w & (cap - 1));
+		std::memcpy(dst, &rec, sizeof(rec));
+		if (len) std::memcpy(dst + sizeof(rec), payload, len);
+
+		hdr->writePos.store(w + need, std::memory_order_release);
+		data.notify();
+		return true;
+	}
+
+	uint32_t spaceSeq() const { return space.current(); }
+	void waitForSpace(uint32_t seen, uint32_t timeoutMs) { space.wait(seen, timeoutMs); }
+
+	// Largest payload write() will ever accept.
+	uint32_t maxPayload() const { return hdr->capacity / 2 - (uint32_t)sizeof(BlShmRecord); }
+
+	// Also wakes a writer waiting for room, so it sees the stop.
+	void invalidate() {
+		hdr->epoch.fetch_add(1, std::memory_order_release);
+		space.notify();
+	}
+	uint32_t epoch() const { return hdr->epoch.load(std::memory_order_acquire); }
+
+	// Call before taking the next item off the wrapper's stream, not when
+	// writing it: a stop in between then leaves the item stamped with the
+	// epoch it ended, rather than passing it off as part of the next one.
+	void stampEpoch() { stamp = epoch(); }
+	uint32_t stamped() const { return stamp; }
+	void countDrop() { hdr->droppedRecords.fetch_add(1, std::memory_order_relaxed); }
+
+	static uint32_t recordBytes(uint32_t len) {
+		return (uint32_t)((sizeof(BlShmRecord) + len + 15u) & ~15u);
+	}
+
+private:
+	SharedMemoryRegion region;
+	BlShmHeader* hdr = nullptr;
+	BlShmSignal data;
+	BlShmSignal space;
+	uint32_t stamp = 0;
+};
+
+// Consumer end, same shape as bl_acquireAudio/bl_releaseAudio: front() looks
+// at the next live record in place, pop() hands its space back. To wait for
+// records, take dataSeq() before front() and pass it to waitForData() if
+// that found nothing.
+class BlShmReader {
+public:
+	bool open(const char* name) {
+		if (!region.open(name) || region.size() < BL_SHM_HEADER_BYTES) { region.close(); return false; }
+		hdr = reinterpret_cast<BlShmHeader*>(region.data());
+		if (hdr->magic != BL_SHM_MAGIC || hdr->version != BL_SHM_VERSION ||
+			region.size() < (size_t)hdr->headerBytes + hdr->capacity) {
+			region.close();
+			hdr = nullptr;
+			return false;
+		}
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (!data.open(name, BL_SHM_DATA_EVENT, &hdr->dataSeq, &hdr->dataWaiters, false) ||
+			!space.open(name, BL_SHM_SPACE_EVENT, &hdr->spaceSeq, &hdr->spaceWaiters, false)) {
+			data.close();
+			region.close();
+			hdr = nullptr;
+			return false;
+		}
+		return true;
+	}
+
+	// Next record of the current epoch, or nullptr if none is ready. Pads and
+	// records from before the last stop are consumed on the way.
+	const BlShmRecord* front(const uint8_t** payload) {
+		const uint32_t cap = hdr->capacity;
+		const uint8_t* ring = region.data() + hdr->headerBytes;
+		while (true) {
+			const uint32_t r = hdr->readPos.load(std::memory_order_relaxed);
+			const uint32_t w = hdr->writePos.load(std::memory_order_acquire);
+			if (r == w) return nullptr;
+
+			const uint32_t off = r & (cap - 1);
+			const BlShmRecord* rec = reinterpret_cast<const BlShmRecord*>(ring + off);
+			if (rec->type == BL_SHM_PAD) {
+				hdr->readPos.store(r + (cap - off), std::memory_order_release);
+				space.notify();
+				continue;
+			}
+			if (rec->epoch != hdr->epoch.load(std::memory_order_acquire)) { pop(); continue; }
+
+			if (payload) *payload = rec->len ? reinterpret_cast<const uint8_t*>(rec + 1) : nullptr;
+			return rec;
+		}
+	}
+
+	void pop() {
+		const uint32_t r = hdr->readPos.load(std::memory_order_relaxed);
+		const BlShmRecord* rec = reinterpret_cast<const BlShmRecord*>(
+			region.data() + hdr->headerBytes + (r & (hdr->capacity - 1)));
+		hdr->readPos.store(r + BlShmWriter::recordBytes(rec->len), std::memory_order_release);
+		space.notify();
+	}
+
+	uint32_t dataSeq() const { return data.current(); }
+	void waitForData(uint32_t seen, uint32_t timeoutMs) { data.wait(seen, timeoutMs); }
+
+	uint32_t droppedRecords() const { return hdr->droppedRecords.load(std::memory_order_relaxed); }
+
+private:
+	SharedMemoryRegion region;
+	BlShmHeader* hdr = nullptr;
+	BlShmSignal data;
+	BlShmSignal space;
+};
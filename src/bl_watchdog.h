@@ -0,0 +1,98 @@
+// bl_watchdog.h
+//
+// The engine watchdog's rules: how long a chunk may take, from its length and
+// the speech rate learned from earlier chunks, and the verdict on each poll
+// while the worker waits for the done callback. Time is passed in rather than
+// read, and there are no Windows headers, so the rules can be run against a
+// fake clock and a scripted engine away from tts.dll.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Until a rate is learned, assume slow speech (about 5 characters a second).
+static const int64_t kDefaultUsPerChar = 200000;
+// Deadline = kWatchdogFactor x the expected audio time + kWatchdogSlackUs,
+// clamped to [kWatchdogMinUs, kWatchdogMaxUs].
+static const int64_t kWatchdogFactor = 3;
+static const int64_t kWatchdogSlackUs = 5000000;
+static const int64_t kWatchdogMinUs = 8000000;
+static const int64_t kWatchdogMaxUs = 180000000;
+// No header written and no hook call for this long after StartSay: hung.
+static const int64_t kStallUs = 5000000;
+// Chunks shorter than this are mostly pauses; they don't teach the rate.
+static const size_t kRateMinChars = 16;
+
+// Error codes the worker reports (as BL_ITEM_ERROR) before it recycles the engine.
+static const int kWatchdogTimeoutError = 1002;
+static const int kWatchdogStallError = 1003;
+
+// Learned audio time per character of text. It holds for the tempo it was
+// learned at; after a tempo change the default applies until the next chunk
+// finishes.
+class BlSpeechRate {
+public:
+	int64_t usPerChar(int tempo) const {
+		return (perChar == 0 || tempo != learnedTempo) ? kDefaultUsPerChar : perChar;
+	}
+
+	int64_t budgetUs(size_t chars, int tempo) const {
+		int64_t budget = kWatchdogFactor * (int64_t)chars * usPerChar(tempo) + kWatchdogSlackUs;
+		if (budget < kWatchdogMinUs) budget = kWatchdogMinUs;
+		if (budget > kWatchdogMaxUs) budget = kWatchdogMaxUs;
+		return budget;
+	}
+
+	// A chunk of `chars` characters finished normally with `bytes` of audio.
+	void learn(size_t chars, uint64_t bytes, uint64_t bytesPerSec, int tempo) {
+		if (chars < kRateMinChars || bytesPerSec == 0 || bytes == 0) return;
+		const int64_t sample = (int64_t)((bytes * 1000000ULL) / bytesPerSec) / (int64_t)chars;
+		if (perChar == 0 || learnedTempo != tempo) {
+			perChar = sample;
+			learnedTempo = tempo;
+		} else {
+			perChar += (sample - perChar) / 4;
+		}
+	}
+
+private:
+	int64_t perChar = 0; // 0 = nothing learned yet
+	int learnedTempo = 0;
+};
+
+enum BlEngineVerdict {
+	BL_ENGINE_RUNNING = 0,
+	BL_ENGINE_TIMEOUT,  // over the duration-based deadline (kWatchdogTimeoutError)
+	BL_ENGINE_STALLED   // no audio progress at all (kWatchdogStallError)
+};
+
+// One chunk's watch, from StartSay to done. Time the engine spends inside our
+// hooks (pacing, waiting on the reader) is ours, not the engine's: it doesn't
+// count against the deadline and counts as progress for the stall check, as
+// does every new header. Either verdict other than RUNNING means the engine
+// is stopped and recycled.
+class BlEngineWatch {
+public:
+	BlEngineWatch(int64_t budgetUs, int64_t nowUs, uint32_t hdrsWritten)
+		: budget(budgetUs), last(nowUs), lastProgress(nowUs), lastHdrs(hdrsWritten) {}
+
+	BlEngineVerdict poll(int64_t nowUs, uint32_t hdrsWritten, bool inHook) {
+		if (inHook || hdrsWritten != lastHdrs) {
+			lastHdrs = hdrsWritten;
+			lastProgress = nowUs;
+		}
+		if (!inHook) engineUs += nowUs - last;
+		last = nowUs;
+
+		if (engineUs > budget) return BL_ENGINE_TIMEOUT;
+		if (nowUs - lastProgress > kStallUs) return BL_ENGINE_STALLED;
+		return BL_ENGINE_RUNNING;
+	}
+
+private:
+	int64_t budget;
+	int64_t last;
+	int64_t lastProgress;
+	uint32_t lastHdrs;
+	int64_t engineUs = 0;
+};
@@ -33,6 +33,20 @@ BL_ITEM_AUDIO = 1
 BL_ITEM_DONE = 2
 BL_ITEM_ERROR = 3
 
+BL_FEATURE_CHUNKING = 1
+
+# Descriptors per bl_readMany call.
+READ_MANY_ITEMS = 64
+
+
+class BL_READ_ITEM(ctypes.Structure):
+	_fields_ = [
+		("type", ctypes.c_int),
+		("value", ctypes.c_int),
+		("audioOffset", ctypes.c_int),
+		("audioLen", ctypes.c_int),
+	]
+
 
 class BgThread(threading.Thread):
 	def __init__(self):
@@ -193,6 +207,60 @@ class SynthDriver(SynthDriver):
 		)
 		self._dll.bl_read.restype = ctypes.c_int
 
+		# Zero-copy read API (newer wrappers only)
+		try:
+			self._dll.bl_acquireAudio.argtypes = (
+				ctypes.c_void_p,
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_void_p),
+				ctypes.POINTER(ctypes.c_int)
+			)
+			self._dll.bl_acquireAudio.restype = ctypes.c_int
+			self._dll.bl_releaseAudio.argtypes = (ctypes.c_void_p,)
+			self._dll.bl_releaseAudio.restype = None
+			self._hasZeroCopy = True
+		except AttributeError:
+			self._hasZeroCopy = False
+
+		# Batched read (newer wrappers only)
+		try:
+			self._dll.bl_readMany.argtypes = (
+				ctypes.c_void_p,
+				ctypes.POINTER(BL_READ_ITEM),
+				ctypes.c_int,
+				ctypes.c_void_p,
+				ctypes.c_int,
+				ctypes.POINTER(ctypes.c_int)
+			)
+			self._dll.bl_readMany.restype = ctypes.c_int
+			self._hasReadMany = True
+		except AttributeError:
+			self._hasReadMany = False
+
+		# Blocking read (newer wrappers only)
+		try:
+			self._dll.bl_readWait.argtypes = (
+				ctypes.c_void_p,
+				ctypes.c_int,
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.POINTER(ctypes.c_int),
+				ctypes.c_void_p,
+				ctypes.c_int
+			)
+			self._dll.bl_readWait.restype = ctypes.c_int
+			self._hasReadWait = True
+		except AttributeError:
+			self._hasReadWait = False
+
+		# Wrappers that split long text themselves report it (newer wrappers only)
+		try:
+			self._dll.bl_getFeatures.argtypes = ()
+			self._dll.bl_getFeatures.restype = ctypes.c_int
+			self._wrapperChunks = bool(self._dll.bl_getFeatures() & BL_FEATURE_CHUNKING)
+		except AttributeError:
+			self._wrapperChunks = False
+
 		self._dll.bl_getTempo.argtypes = (ctypes.c_void_p,)
 		self._dll.bl_getTempo.restype = ctypes.c_int
 		self._dll.bl_setTempo.argtypes = (ctypes.c_void_p, ctypes.c_int)
@@ -234,6 +302,7 @@ class SynthDriver(SynthDriver):
 		# Reusable buffer for audio pulls
 		self._bufSize = 65536
 		self._audioBuf = ctypes.create_string_buffer(self._bufSize)
+		self._readItemsBuf = (BL_READ_ITEM * READ_MANY_ITEMS)()
 
 	def _quantizePercent(self, value, step):
 		try:
@@ -377,34 +446,84 @@ class SynthDriver(SynthDriver):
 
 		_execWhenDone(self._speakBg, blocks, mustBeAsync=True)
 
+	def _readItem(self, outType, outValue, outData, outLen):
+		# Returns (type, value, audio bytes) for the next wrapper queue item.
+		if self._hasZeroCopy:
+			if not self._dll.bl_acquireAudio(
+				self._handle,
+				ctypes.byref(outType),
+				ctypes.byref(outValue),
+				ctypes.byref(outData),
+				ctypes.byref(outLen)
+			):
+				return BL_ITEM_NONE, 0, b""
+			try:
+				n = outLen.value
+				data = ctypes.string_at(outData.value, n) if n > 0 else b""
+			finally:
+				self._dll.bl_releaseAudio(self._handle)
+			return outType.value, outValue.value, data
+
+		n = self._dll.bl_read(
+			self._handle,
+			ctypes.byref(outType),
+			ctypes.byref(outValue),
+			self._audioBuf,
+			self._bufSize
+		)
+		t = outType.value
+		data = ctypes.string_at(self._audioBuf, n) if (t == BL_ITEM_AUDIO and n > 0) else b""
+		return t, outValue.value, data
+
+	def _readItems(self, outType, outValue, outData, outLen):
+		# Everything the wrapper has queued, as (type, value, audio bytes);
+		# one call with bl_readMany, else one item at a time.
+		if not self._hasReadMany:
+			t, v, data = self._readItem(outType, outValue, outData, outLen)
+			return [] if t == BL_ITEM_NONE else [(t, v, data)]
+
+		count = self._dll.bl_readMany(
+			self._handle,
+			self._readItemsBuf,
+			READ_MANY_ITEMS,
+			self._audioBuf,
+			self._bufSize,
+			ctypes.byref(outLen)
+		)
+		base = ctypes.addressof(self._audioBuf)
+		items = []
+		for i in range(count):
+			d = self._readItemsBuf[i]
+			data = ctypes.string_at(base + d.audioOffset, d.audioLen) if d.audioLen > 0 else b""
+			items.append((d.type, d.value, data))
+		return items
+
 	def _pumpUntilDone(self):
 		outType = ctypes.c_int(0)
 		outValue = ctypes.c_int(0)
+		outData = ctypes.c_void_p(None)
+		outLen = ctypes.c_int(0)
 
+		failed = False
 		while self.speaking:
-			madeProgress = False
-
-			while True:
-				try:
-					n = self._dll.bl_read(
-						self._handle,
-						ctypes.byref(outType),
-						ctypes.byref(outValue),
-						self._audioBuf,
-						self._bufSize
-					)
-				except Exception:
-					log.error("Brailab: bl_read crashed", exc_info=True)
-					return False
-
-				t = outType.value
-				v = outValue.value
+			try:
+				items = self._readItems(outType, outValue, outData, outLen)
+			except Exception:
+				log.error("Brailab: bl_read crashed", exc_info=True)
+				return False
+
+			for t, v, data in items:
+				if failed:
+					# ERROR is always followed by the utterance's own DONE; read up
+					# to it, or the next utterance would take it for its own.
+					if t == BL_ITEM_DONE:
+						return False
+					continue
 
 				if t == BL_ITEM_AUDIO:
-					if n > 0:
-						madeProgress = True
+					if data:
 						try:
-							self._player.feed(self._audioBuf.raw[:n], n)
+							self._player.feed(data, len(data))
 						except Exception:
 							log.error("Brailab: nvwave feed error", exc_info=True)
 							return False
@@ -415,12 +534,14 @@ class SynthDriver(SynthDriver):
 
 				if t == BL_ITEM_ERROR:
 					log.error(f"Brailab: wrapper reported error {v}")
-					return False
-
-				break
+					failed = True
 
-			if not madeProgress:
-				time.sleep(0.001)
+			if not items:
+				if self._hasReadWait:
+					# Parks until audio/markers arrive or bl_stop; no polling.
+					self._dll.bl_readWait(self._handle, 50, ctypes.byref(outType), ctypes.byref(outValue), None, 0)
+				else:
+					time.sleep(0.001)
 
 		return False
 
@@ -449,6 +570,13 @@ class SynthDriver(SynthDriver):
 
 		self._player.feed(b"", 0, onDone=cb)
 
+	def _segments(self, text):
+		# Newer wrappers split long text at punctuation/whitespace themselves;
+		# older ones need it cut to the engine's limit here.
+		if self._wrapperChunks:
+			return [text]
+		return [text[i:i + MAX_STRING_LENGTH] for i in range(0, len(text), MAX_STRING_LENGTH)]
+
 	def _speakBg(self, blocks):
 		self.speaking = True
 
@@ -460,9 +588,7 @@ class SynthDriver(SynthDriver):
 
 			# Speak text (can be empty)
 			if text:
-				segments = [text[i:i + MAX_STRING_LENGTH] for i in range(0, len(text), MAX_STRING_LENGTH)]
-
-				for seg in segments:
+				for seg in self._segments(text):
 					if not self.speaking:
 						break
 
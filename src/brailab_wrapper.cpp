@@ -13,12 +13,16 @@
 #include <mmsystem.h>
 #include <intrin.h>
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <cwchar>
 #include <deque>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -28,6 +32,17 @@
 
 #include "MinHook.h"
 
+#include "bl_chunker.h"
+#include "bl_clock.h"
+#include "bl_cmdqueue.h"
+#include "bl_dict.h"
+#include "bl_normalize.h"
+#include "bl_pool.h"
+#include "bl_ring.h"
+#include "bl_sanitize.h"
+#include "bl_shm.h"
+#include "bl_watchdog.h"
+
 #pragma comment(lib, "user32.lib")
 
 // ------------------------------------------------------------
@@ -106,7 +121,8 @@ struct StreamItem {
 	int type = BL_ITEM_NONE;
 	int value = 0;
 	uint32_t gen = 0;
-	std::vector<uint8_t> data;
+	uint8_t* data = nullptr; // pooled block (BL_ITEM_AUDIO only)
+	size_t size = 0;
 	size_t offset = 0;
 
 	StreamItem() = default;
@@ -120,6 +136,7 @@ struct CmdPart {
 	enum Kind { PART_TEXT = 0, PART_INDEX = 1 } kind = PART_TEXT;
 	std::wstring text;
 	int index = 0;
+	bool ready = false; // text is already what StartSay gets (worker)
 
 	CmdPart() = default;
 	static CmdPart Text(std::wstring t) {
@@ -128,6 +145,11 @@ struct CmdPart {
 		p.text = std::move(t);
 		return p;
 	}
+	static CmdPart Ready(std::wstring t) {
+		CmdPart p = Text(std::move(t));
+		p.ready = true;
+		return p;
+	}
 	static CmdPart Index(int i) {
 		CmdPart p;
 		p.kind = PART_INDEX;
@@ -142,6 +164,32 @@ struct Cmd {
 	std::wstring text; // used for CMD_SPEAK
 	bool noIntonation = false;
 	std::vector<CmdPart> parts; // used for CMD_UTTERANCE
+	int64_t enqueuedUs = 0;
+	int lane = LANE_NORMAL;
+	bool resumeAfter = false; // priority: resume what it preempted afterwards
+	bool noCoalesce = false;  // never dropped or merged (bl_renderToBufferW)
+};
+
+// ------------------------------------------------------------
+// Latency timeline (bl_getStats)
+// ------------------------------------------------------------
+enum TimeMark {
+	MARK_ENQUEUE = 0,
+	MARK_DEQUEUE,
+	MARK_START_SAY,
+	MARK_FIRST_CAPTURE,
+	MARK_FIRST_READ,
+	MARK_ENGINE_DONE,
+	MARK_DONE,
+	MARK_COUNT
+};
+
+// One slot per recent utterance, indexed by gen. Each stage stamps its own
+// field with a plain atomic store, so nothing on the audio path waits on stats.
+struct UtteranceTimes {
+	std::atomic<uint32_t> gen{ 0 };
+	std::atomic<int> flags{ 0 };
+	std::atomic<int64_t> at[MARK_COUNT] = {};
 };
 
 struct BL_STATE {
@@ -181,15 +229,57 @@ struct BL_STATE {
 	std::atomic<uint32_t> cancelToken{ 1 };
 	std::atomic<uint32_t> genCounter{ 1 };
 	std::atomic<uint32_t> activeGen{ 0 };   // hooks capture only while nonzero
-	std::atomic<uint32_t> currentGen{ 0 };  // reader consumes only this gen
+	std::atomic<uint32_t> currentGen{ 0 };  // gen the worker is producing (0 = none)
+	std::atomic<uint32_t> minLiveGen{ 1 };  // reader drops anything older (raised by bl_stop)
 
 	// Output pacing data
 	std::atomic<uint64_t> bytesPerSec{ 0 };
-	std::atomic<ULONGLONG> lastAudioTick{ 0 };
+	std::atomic<int64_t> lastAudioUs{ 0 };
+
+	// REALTIME pacing: when the audio written so far is due to finish playing.
+	// Each buffer extends it, so late wakeups don't accumulate (capture thread).
+	std::atomic<int64_t> paceDeadlineUs{ 0 };
+	BlPacingTimer paceTimer;   // capture thread
+	BlPacingTimer graceTimer;  // worker
+
+	// Headers the engine has passed to waveOutWrite, and those we've handed
+	// back. Equal means nothing is in flight (end-of-chunk detection).
+	std::atomic<uint32_t> hdrsWritten{ 0 };
+	std::atomic<uint32_t> hdrsCompleted{ 0 };
+	// Engine threads inside hook_waveOutWrite right now, and how many of those
+	// are parked in waitForQueueRoom/waitForLookahead waiting on the reader.
+	std::atomic<int> hooksInFlight{ 0 };
+	std::atomic<int> hooksParked{ 0 };
+	// Signalled when hooksInFlight drops to 0 (waitForHooksIdle).
+	std::mutex hooksIdleMtx;
+	std::condition_variable hooksIdleCv;
+	// Audio bytes accepted from the engine (any gen), for the speech-rate estimate.
+	std::atomic<uint64_t> capturedBytes{ 0 };
+
+	// Watchdog (worker only): audio time per character learned so far.
+	int initValue = 0;
+	BlSpeechRate speechRate;
 
 	// Warmup credit: allow the first N ms of audio to be generated without sleeping.
 	std::atomic<int> throttleCreditMs{ 0 };
 
+	// Pacing (BL_PACING_*). LOOKAHEAD lets the engine run flat out until
+	// lookaheadMs of audio is queued, then only as fast as the reader drains it.
+	std::atomic<int> pacingMode{ BL_PACING_LOOKAHEAD };
+	std::atomic<uint32_t> lookaheadMs{ 300 };
+	std::atomic<int> maxBufferedMs{ 30000 }; // overflow limit, as duration
+
+	// bl_renderToBufferW in progress: no pacing at all, hooks complete at once.
+	// The rendering thread owns the stream; other readers see nothing.
+	std::atomic<bool> renderMode{ false };
+	std::atomic<std::thread::id> renderOwner{};
+
+	// Desired pacing budget (bl_setLookaheadMs stores these; worker applies
+	// them at the start of the next utterance)
+	std::atomic<int> desiredBurstMs{ 200 };
+	std::atomic<int> desiredLookaheadMs{ 300 };
+	std::atomic<int> desiredMaxBufferedMs{ 30000 };
+
 	// Desired settings (setters store these; worker applies them before StartSay)
 	std::atomic<int> desiredTempo{ 0 };
 	std::atomic<int> desiredPitch{ 0 };
@@ -198,7 +288,26 @@ struct BL_STATE {
 	// Worker
 	std::mutex cmdMtx;
 	std::condition_variable cmdCv;
-	std::deque<Cmd> cmdQ;
+	LaneQueue<Cmd> cmdQ;
+	// Priority commands waiting; lets the worker check at part boundaries
+	// without taking cmdMtx.
+	std::atomic<int> priorityQueued{ 0 };
+	// Text normalization (bl_setNormalization), read once per utterance.
+	std::atomic<unsigned> normalizeFlags{ 0 };
+	std::wstring normScratch; // worker: reused so normalizing doesn't allocate
+	// Pronunciation dictionary (bl_loadDictionaryW). The loader publishes into
+	// dictPending; the worker takes it at the start of an utterance and owns
+	// `dict` from then on, so the swap needs no lock and a mapping is never
+	// closed under the worker.
+	std::atomic<BlDictionary*> dictPending{ nullptr };
+	std::unique_ptr<BlDictionary> dict; // worker
+	std::wstring dictScratch;           // worker
+
+	// Coalescing (bl_setCoalescing; protected by cmdMtx)
+	int coalesceMode = BL_COALESCE_OFF;
+	int coalesceMaxDepth = 0;
+	uint32_t coalescedDropped = 0;
+	uint32_t coalescedMerged = 0;
 	// Composite utterance builder (protected by cmdMtx)
 	bool buildActive = false;
 	bool buildNoIntonation = false;
@@ -206,13 +315,70 @@ struct BL_STATE {
 	bool quitting = false;
 	std::thread worker;
 
-	// Output queue
-	std::mutex outMtx;
-	std::deque<StreamItem> outQ;
-	size_t queuedAudioBytes = 0;
-
-	size_t maxBufferedBytes = 0; // computed from format, else default
-	size_t maxQueueItems = 8192;
+	// Output queue: lock-free SPSC ring between the capture side and bl_read.
+	// pushMtx serializes the producers (engine thread audio, worker markers);
+	// readMtx serializes the consumer side (bl_read, clears, overflow drops).
+	// A producer only takes readMtx when the queue overflows.
+	static const size_t maxQueueItems = 8192;
+	SpscRing<StreamItem> outQ{ maxQueueItems };
+	// Audio blocks referenced by outQ slots: taken under pushMtx, given back
+	// (and grown) under readMtx, so steady-state capture never allocates.
+	AudioBlockPool audioPool{ maxQueueItems };
+	std::mutex pushMtx;
+	std::mutex readMtx;
+	std::atomic<size_t> queuedAudioBytes{ 0 };
+	// Front item handed out by bl_acquireAudio and not yet released (set under
+	// readMtx, read by parked readers too), and how many items its view spans
+	// (readMtx).
+	std::atomic<bool> frontAcquired{ false };
+	std::atomic<std::thread::id> frontHolder{};
+	size_t acquiredItems = 0;
+
+	// bl_readWait parking. Producers only touch waitMtx when a reader is parked.
+	std::mutex waitMtx;
+	std::condition_variable outCv;
+	std::atomic<int> readWaiters{ 0 };
+	uint32_t readWakeSeq = 0; // bumped by bl_stop/bl_free (waitMtx)
+
+	std::atomic<size_t> maxBufferedBytes{ 0 }; // computed from format, else default
+
+	// Overflow handling (BL_OVERFLOW_*). In BLOCK mode the capture thread parks
+	// on drainCv until the reader brings queuedAudioBytes under the low watermark.
+	std::atomic<int> overflowPolicy{ BL_OVERFLOW_BLOCK };
+	std::mutex drainMtx;
+	std::condition_variable drainCv;
+	std::atomic<int> drainWaiters{ 0 };
+	std::atomic<size_t> drainWakeBytes{ 0 }; // notify once queuedAudioBytes gets down to this
+	std::atomic<uint64_t> droppedBytes{ 0 };
+	std::atomic<uint32_t> droppedBlocks{ 0 };
+	std::atomic<uint32_t> overflowWaits{ 0 };
+
+	// Push-mode delivery (bl_setAudioSink). The sink thread is one more
+	// consumer: it goes through bl_acquireAudio/bl_releaseAudio like any other.
+	std::mutex sinkMtx;
+	std::condition_variable sinkCv;
+	BL_AUDIO_SINK sink = nullptr;
+	void* sinkUser = nullptr;
+	bool sinkBusy = false;     // sink is being called (sinkMtx)
+	bool sinkQuit = false;     // sinkMtx
+	uint32_t sinkWakeSeq = 0;  // bumped on sink changes/quit (waitMtx)
+	std::thread sinkThread;
+
+	// Shared-memory output (bl_openSharedOutput), fed through the sink thread.
+	std::mutex shmMtx;
+	std::unique_ptr<BlShmWriter> shmOut; // shmMtx
+
+	// Latency timeline (bl_getStats)
+	UtteranceTimes times[BL_STATS_HISTORY];
+	std::atomic<uint32_t> finishedUtterances{ 0 };
+
+	// Stop latency (bl_getStopStats). stopRequestUs is the first bl_stop the
+	// worker hasn't answered yet (0 = none); the samples are stopStatsMtx.
+	std::atomic<int64_t> stopRequestUs{ 0 };
+	std::mutex stopStatsMtx;
+	int32_t stopEngineUs[BL_STATS_HISTORY] = {};
+	int32_t stopIdleUs[BL_STATS_HISTORY] = {};
+	uint32_t stopsMeasured = 0;
 };
 
 static BL_STATE* g_state = nullptr;
@@ -234,6 +400,37 @@ static bool isCallerFromModule(HMODULE expectedModule) {
 	return caller == expectedModule;
 }
 
+static UtteranceTimes* timesFor(BL_STATE* s, uint32_t gen) {
+	if (gen == 0) return nullptr;
+	UtteranceTimes* u = &s->times[gen % BL_STATS_HISTORY];
+	return (u->gen.load(std::memory_order_acquire) == gen) ? u : nullptr;
+}
+
+// Worker, at dequeue: claim the slot for `gen`.
+static void beginTimes(BL_STATE* s, uint32_t gen, int64_t enqueuedUs) {
+	UtteranceTimes* u = &s->times[gen % BL_STATS_HISTORY];
+	u->gen.store(0, std::memory_order_relaxed);
+	for (auto& a : u->at) a.store(0, std::memory_order_relaxed);
+	u->flags.store(0, std::memory_order_relaxed);
+	u->at[MARK_ENQUEUE].store(enqueuedUs, std::memory_order_relaxed);
+	u->at[MARK_DEQUEUE].store(blNowUs(), std::memory_order_relaxed);
+	u->gen.store(gen, std::memory_order_release);
+}
+
+// Stamp `mark` for `gen`. firstOnly keeps an earlier stamp (and skips the
+// clock read), which is what the per-block call sites want.
+static void markTime(BL_STATE* s, uint32_t gen, int mark, bool firstOnly) {
+	UtteranceTimes* u = timesFor(s, gen);
+	if (!u) return;
+	if (firstOnly && u->at[mark].load(std::memory_order_relaxed) != 0) return;
+	u->at[mark].store(blNowUs(), std::memory_order_relaxed);
+}
+
+static void markFlag(BL_STATE* s, uint32_t gen, int flag) {
+	UtteranceTimes* u = timesFor(s, gen);
+	if (u) u->flags.fetch_or(flag, std::memory_order_relaxed);
+}
+
 static void signalWaveOutMessage(BL_STATE* s, UINT msg, WAVEHDR* hdr) {
 	if (!s) return;
 
@@ -277,9 +474,232 @@ static void signalWaveOutMessage(BL_STATE* s, UINT msg, WAVEHDR* hdr) {
 	}
 }
 
+static size_t bufferLimit(const BL_STATE* s) {
+	const size_t limit = s->maxBufferedBytes.load(std::memory_order_relaxed);
+	return (limit > 0) ? limit : (size_t)(512 * 1024);
+}
+
+// BLOCK mode resumes capture once the reader gets down to here.
+static size_t lowWatermark(const BL_STATE* s) {
+	return bufferLimit(s) / 2;
+}
+
+// Consumer side: account for audio leaving the queue and release a capture
+// thread parked in waitForQueueRoom/waitForLookahead once it's low enough.
+static void releaseQueuedAudio(BL_STATE* s, size_t n) {
+	const size_t left = s->queuedAudioBytes.fetch_sub(n, std::memory_order_relaxed) - n;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (s->drainWaiters.load(std::memory_order_relaxed) == 0) return;
+	if (left > s->drainWakeBytes.load(std::memory_order_relaxed)) return;
+	{ std::lock_guard<std::mutex> g(s->drainMtx); }
+	s->drainCv.notify_all();
+}
+
+static void wakeCaptureThread(BL_STATE* s) {
+	{ std::lock_guard<std::mutex> g(s->drainMtx); }
+	s->drainCv.notify_all();
+}
+
+// Consumer side only (readMtx held). The slot and block are free before a
+// parked capture thread is woken, since BLOCK mode waits on those too.
+static void popOutputItemLocked(BL_STATE* s) {
+	StreamItem* it = s->outQ.front();
+	if (!it) return;
+	const size_t remaining = (it->type == BL_ITEM_AUDIO && it->size > it->offset) ? (it->size - it->offset) : 0;
+	s->audioPool.give(it->data);
+	it->data = nullptr;
+	it->size = 0;
+	it->offset = 0;
+	s->outQ.pop();
+	if (remaining) releaseQueuedAudio(s, remaining);
+	else if (s->drainWaiters.load(std::memory_order_relaxed) > 0) wakeCaptureThread(s);
+}
+
 static void clearOutputQueueLocked(BL_STATE* s) {
-	s->outQ.clear();
-	s->queuedAudioBytes = 0;
+	// An item handed out by bl_acquireAudio must stay put until it is released,
+	// and a ring can't be cleared past its front. Whatever is queued behind it
+	// has a stale gen by now, so the next read drops it anyway.
+	if (s->frontAcquired) return;
+	while (s->outQ.front()) popOutputItemLocked(s);
+}
+
+// Producer side: wake a reader parked in bl_readWait, if any.
+static void notifyReader(BL_STATE* s) {
+	// Pairs with the fence in bl_readWait: either the reader sees the item we
+	// just published, or we see the reader and take waitMtx to notify it.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (s->readWaiters.load(std::memory_order_relaxed) == 0) return;
+	{ std::lock_guard<std::mutex> g(s->waitMtx); }
+	s->outCv.notify_all();
+}
+
+static void wakeReaders(BL_STATE* s) {
+	{
+		std::lock_guard<std::mutex> g(s->waitMtx);
+		++s->readWakeSeq;
+	}
+	s->outCv.notify_all();
+}
+
+// Kick the sink thread out of its outCv park so it re-reads sink/sinkQuit.
+static void wakeSink(BL_STATE* s) {
+	{
+		std::lock_guard<std::mutex> g(s->waitMtx);
+		++s->sinkWakeSeq;
+	}
+	s->outCv.notify_all();
+}
+
+// Items of a stopped utterance. Utterances that simply ended stay live, so a
+// finished one's unread tail and DONE still come out ahead of the next one.
+static bool isStaleGen(const BL_STATE* s, uint32_t gen) {
+	return gen < s->minLiveGen.load(std::memory_order_relaxed);
+}
+
+// A bl_renderToBufferW on another thread owns the stream.
+static bool renderOwnedElsewhere(const BL_STATE* s) {
+	const std::thread::id owner = s->renderOwner.load(std::memory_order_acquire);
+	return owner != std::thread::id() && owner != std::this_thread::get_id();
+}
+
+// A bl_acquireAudio view is out on another thread.
+static bool frontHeldElsewhere(const BL_STATE* s) {
+	return s->frontAcquired.load(std::memory_order_acquire) &&
+		s->frontHolder.load(std::memory_order_relaxed) != std::this_thread::get_id();
+}
+
+// Parked readers: is there something a read could take once it gets readMtx?
+// Not while another thread holds the front or renders; bl_releaseAudio and
+// the end of the render wake them.
+static bool outputReadable(const BL_STATE* s) {
+	return !s->outQ.empty() && !frontHeldElsewhere(s) && !renderOwnedElsewhere(s);
+}
+
+// Consumer side (readMtx held): front live item, dropping stale ones on the
+// way. Returns nullptr while a bl_acquireAudio view is out, or while another
+// thread is rendering.
+static StreamItem* readableFrontLocked(BL_STATE* s) {
+	if (s->frontAcquired || renderOwnedElsewhere(s)) return nullptr;
+
+	StreamItem* front = s->outQ.front();
+	while (front && isStaleGen(s, front->gen)) {
+		popOutputItemLocked(s);
+		front = s->outQ.front();
+	}
+	if (front && front->type == BL_ITEM_AUDIO) markTime(s, front->gen, MARK_FIRST_READ, true);
+	return front;
+}
+
+// Producer side (pushMtx held): make room by discarding the oldest queued
+// item, O(1). Stops at a live marker so INDEX/DONE are never lost. Stale
+// items are reclaimed without counting as a drop.
+static bool dropOldestAudio(BL_STATE* s) {
+	std::lock_guard<std::mutex> g(s->readMtx);
+	StreamItem* it = s->outQ.front();
+	if (!it || s->frontAcquired) return false;
+	const bool live = !isStaleGen(s, it->gen);
+	if (live && it->type != BL_ITEM_AUDIO) return false;
+	if (live) {
+		s->droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+		s->droppedBytes.fetch_add(it->size - it->offset, std::memory_order_relaxed);
+	}
+	popOutputItemLocked(s);
+	return true;
+}
+
+// Producer side: audio that never made it into the queue.
+static void dropIncomingAudio(BL_STATE* s, size_t bytes) {
+	s->droppedBlocks.fetch_add(1, std::memory_order_relaxed);
+	s->droppedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+// Capture side: audio from a stopped utterance still counts until someone
+// pops it. Reclaim that ourselves, down to `target` queued bytes, rather than
+// wait on a reader that may never come for it.
+static void reclaimStaleAudio(BL_STATE* s, size_t target) {
+	std::lock_guard<std::mutex> g(s->readMtx);
+	StreamItem* it = s->frontAcquired ? nullptr : s->outQ.front();
+	while (it && isStaleGen(s, it->gen) && s->queuedAudioBytes.load(std::memory_order_relaxed) > target) {
+		popOutputItemLocked(s);
+		it = s->outQ.front();
+	}
+}
+
+// Producer side, BL_OVERFLOW_BLOCK: can `size` more audio bytes (0 = a marker)
+// go in without dropping anything? That takes room under the byte limit (any
+// size fits at the low watermark), plus a ring slot and a pool block per block.
+static bool queueHasRoom(BL_STATE* s, size_t size) {
+	size_t blocks = (size + AudioBlockPool::blockBytes - 1) / AudioBlockPool::blockBytes;
+	if (blocks > s->audioPool.blockCount()) blocks = s->audioPool.blockCount();
+	if (s->audioPool.freeCount() < blocks) return false;
+	if (s->outQ.capacity() - s->outQ.size() < (blocks ? blocks : 1)) return false;
+	if (size == 0) return true;
+
+	const size_t queued = s->queuedAudioBytes.load(std::memory_order_relaxed);
+	return queued + size <= bufferLimit(s) || queued <= lowWatermark(s);
+}
+
+// Producer side, BL_OVERFLOW_BLOCK: park the engine thread (or the worker,
+// for a marker) until queueHasRoom, resuming audio at the low watermark, or
+// until the utterance is stopped. Returns false if `gen` went stale
+// meanwhile. Holds no other lock.
+static bool waitForQueueRoom(BL_STATE* s, uint32_t gen, size_t size) {
+	if (queueHasRoom(s, size)) return true;
+
+	const size_t limit = bufferLimit(s);
+	reclaimStaleAudio(s, (size < limit) ? limit - size : 0);
+	if (queueHasRoom(s, size)) return true;
+
+	s->overflowWaits.fetch_add(1, std::memory_order_relaxed);
+
+	std::unique_lock<std::mutex> lk(s->drainMtx);
+	// A marker only needs a slot: any pop may free one.
+	s->drainWakeBytes.store(size ? lowWatermark(s) : SIZE_MAX, std::memory_order_relaxed);
+	s->drainWaiters.fetch_add(1, std::memory_order_relaxed);
+	s->hooksParked.fetch_add(1, std::memory_order_acq_rel);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	auto ready = [&]() {
+		return s->currentGen.load(std::memory_order_relaxed) != gen ||
+			s->overflowPolicy.load(std::memory_order_relaxed) != BL_OVERFLOW_BLOCK ||
+			(queueHasRoom(s, size) && (size == 0 || s->queuedAudioBytes.load(std::memory_order_relaxed) <= lowWatermark(s)));
+	};
+	// Notified by the reader and by bl_stop; the timeout is only a safety net.
+	while (!ready()) s->drainCv.wait_for(lk, std::chrono::milliseconds(100));
+
+	s->hooksParked.fetch_sub(1, std::memory_order_acq_rel);
+	s->drainWaiters.fetch_sub(1, std::memory_order_relaxed);
+	return s->currentGen.load(std::memory_order_relaxed) == gen;
+}
+
+// Capture side, BL_PACING_LOOKAHEAD: no wait while less than lookaheadMs of
+// audio is queued; past that, hold the engine until the reader has taken it
+// back under the target, so generation tracks consumption rather than the clock.
+static void waitForLookahead(BL_STATE* s, uint32_t gen) {
+	uint64_t bps = s->bytesPerSec.load(std::memory_order_relaxed);
+	if (bps == 0) bps = 22050;
+	const size_t target = (size_t)((bps * s->lookaheadMs.load(std::memory_order_relaxed)) / 1000ULL);
+	if (s->queuedAudioBytes.load(std::memory_order_relaxed) <= target) return;
+
+	reclaimStaleAudio(s, target);
+	if (s->queuedAudioBytes.load(std::memory_order_relaxed) <= target) return;
+
+	std::unique_lock<std::mutex> lk(s->drainMtx);
+	s->drainWakeBytes.store(target, std::memory_order_relaxed);
+	s->drainWaiters.fetch_add(1, std::memory_order_relaxed);
+	s->hooksParked.fetch_add(1, std::memory_order_acq_rel);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+
+	auto ready = [&]() {
+		return s->currentGen.load(std::memory_order_relaxed) != gen ||
+			s->pacingMode.load(std::memory_order_relaxed) != BL_PACING_LOOKAHEAD ||
+			s->queuedAudioBytes.load(std::memory_order_relaxed) <= target;
+	};
+	// Notified by the reader and by bl_stop; the timeout is only a safety net.
+	while (!ready()) s->drainCv.wait_for(lk, std::chrono::milliseconds(100));
+
+	s->hooksParked.fetch_sub(1, std::memory_order_acq_rel);
+	s->drainWaiters.fetch_sub(1, std::memory_order_relaxed);
 }
 
 static void computeBufferLimits(BL_STATE* s) {
@@ -288,133 +708,162 @@ static void computeBufferLimits(BL_STATE* s) {
 	uint64_t bps = s->bytesPerSec.load(std::memory_order_relaxed);
 	if (bps == 0) bps = 22050; // safe-ish default (11025 Hz mono 16-bit)
 
-	// Allow up to 30 seconds buffered (still tiny in memory for 11025 mono).
-	uint64_t bytes = bps * 30ULL;
+	// Allow up to maxBufferedMs buffered (30 seconds by default, still tiny in
+	// memory for 11025 mono).
+	uint64_t bytes = (bps * (uint64_t)s->maxBufferedMs.load(std::memory_order_relaxed)) / 1000ULL;
 
-	if (bytes < 256ULL * 1024ULL) bytes = 256ULL * 1024ULL;
+	if (bytes < 64ULL * 1024ULL) bytes = 64ULL * 1024ULL;
 	if (bytes > 8ULL * 1024ULL * 1024ULL) bytes = 8ULL * 1024ULL * 1024ULL;
 
-	s->maxBufferedBytes = (size_t)bytes;
+	s->maxBufferedBytes.store((size_t)bytes, std::memory_order_relaxed);
+
+	// Blocks are rarely full (the engine picks its own buffer sizes), so keep
+	// twice the byte budget around. Grow-only: a format change is the only
+	// time capture may allocate.
+	size_t blocks = (size_t)((bytes * 2ULL) / AudioBlockPool::blockBytes);
+	if (blocks < 128) blocks = 128;
+	{
+		std::lock_guard<std::mutex> g(s->readMtx);
+		s->audioPool.grow(blocks);
+	}
 }
 
-// UTF-16 -> CP1250 bytes (replace) -> UTF-16, then cleanup.
-// Replace '?' with space.
+// Same result as the old UTF-16 -> CP1250 -> UTF-16 round trip plus cleanup
+// ('?', controls and NBSP become spaces, whitespace collapsed), in one pass
+// over a precomputed table (bl_sanitize.h). The returned string is the only
+// allocation.
 static std::wstring sanitizeForBrailab(const wchar_t* in) {
 	if (!in) return L"";
 
-	BOOL usedDefault = FALSE;
-	int blen = WideCharToMultiByte(
-		1250,
-		WC_NO_BEST_FIT_CHARS,
-		in,
-		-1,
-		nullptr,
-		0,
-		"?",
-		&usedDefault
-	);
-	if (blen <= 0) return L"";
-
-	std::string bytes;
-	bytes.resize((size_t)blen);
-	WideCharToMultiByte(
-		1250,
-		WC_NO_BEST_FIT_CHARS,
-		in,
-		-1,
-		&bytes[0],
-		blen,
-		"?",
-		&usedDefault
-	);
-
-	int wlen = MultiByteToWideChar(1250, 0, bytes.c_str(), -1, nullptr, 0);
-	if (wlen <= 0) return L"";
-
-	std::wstring out;
-	out.resize((size_t)wlen);
-	MultiByteToWideChar(1250, 0, bytes.c_str(), -1, &out[0], wlen);
-
-	if (!out.empty() && out.back() == L'\0') out.pop_back();
-
-	for (auto& ch : out) {
-		if ((ch < 0x20 && ch != L'\r' && ch != L'\n' && ch != L'\t') || (ch >= 0x7F && ch <= 0x9F)) {
-			ch = L' ';
-		}
-		if (ch == 0x00A0) ch = L' ';
-		if (ch == L'?') ch = L' ';
-	}
-
-	// collapse whitespace
-	std::wstring collapsed;
-	collapsed.reserve(out.size());
-	bool prevSpace = true;
-	for (wchar_t ch : out) {
-		const bool isSpace = (ch == L' ' || ch == L'\t' || ch == L'\r' || ch == L'\n');
-		if (isSpace) {
-			if (!prevSpace) collapsed.push_back(L' ');
-			prevSpace = true;
-		} else {
-			collapsed.push_back(ch);
-			prevSpace = false;
-		}
+	const size_t len = wcslen(in);
+	std::wstring out(len, L'\0');
+	out.resize(blSanitizeInto(in, len, &out[0]));
+	return out;
+}
+
+static_assert(BL_NORM_NUMBERS == kNormNumbers && BL_NORM_ABBREVIATIONS == kNormAbbreviations &&
+	BL_NORM_SYMBOLS == kNormSymbols, "BL_NORM_* are passed straight to blNormalize");
+
+// Worker: text as StartSay gets it. The user dictionary (bl_loadDictionaryW)
+// goes first, so its keys see the text as written, then normalization
+// (bl_setNormalization); each into the worker's reusable scratch buffer.
+static std::wstring prepareSpeechText(BL_STATE* s, const std::wstring& text, unsigned normFlags) {
+	const std::wstring* cur = &text;
+	if (s->dict && s->dict->loaded()) {
+		s->dict->apply(cur->c_str(), cur->size(), s->dictScratch);
+		cur = &s->dictScratch;
+	}
+	if (normFlags) {
+		blNormalize(cur->c_str(), cur->size(), normFlags, s->normScratch);
+		cur = &s->normScratch;
 	}
-	while (!collapsed.empty() && collapsed.back() == L' ') collapsed.pop_back();
-	return collapsed;
+	return sanitizeForBrailab(cur->c_str());
 }
 
 static void enqueueAudioFromHook(BL_STATE* s, uint32_t gen, const void* data, size_t size) {
 	if (!s || !data || size == 0) return;
 
-	std::vector<uint8_t> copied(size);
-	std::memcpy(copied.data(), data, size);
+	s->lastAudioUs.store(blNowUs(), std::memory_order_relaxed);
 
-	s->lastAudioTick.store(GetTickCount64(), std::memory_order_relaxed);
-
-	std::lock_guard<std::mutex> g(s->outMtx);
+	// Backpressure: hold the engine here rather than lose speech. Checked
+	// again under pushMtx, since a worker marker may take the last slot.
+	std::unique_lock<std::mutex> g(s->pushMtx);
+	while (s->overflowPolicy.load(std::memory_order_relaxed) == BL_OVERFLOW_BLOCK && !queueHasRoom(s, size)) {
+		g.unlock();
+		if (!waitForQueueRoom(s, gen, size)) return;
+		g.lock();
+	}
 
+	// The worker gates activeGen off before it pushes DONE, so audio from a
+	// header it stopped waiting for is dropped rather than landing after DONE.
 	const uint32_t curGen = s->currentGen.load(std::memory_order_relaxed);
-	if (curGen == 0 || gen != curGen) return;
+	if (curGen == 0 || gen != curGen || s->activeGen.load(std::memory_order_relaxed) != gen) return;
+	markTime(s, gen, MARK_FIRST_CAPTURE, true);
+	s->capturedBytes.fetch_add(size, std::memory_order_relaxed);
+
+	// Avoid unbounded growth if consumer stalls for a long time (DROP mode, or
+	// the worker's markers raced us past the limit in BLOCK mode).
+	const size_t limit = bufferLimit(s);
+	while (s->queuedAudioBytes.load(std::memory_order_relaxed) + size > limit) {
+		if (!dropOldestAudio(s)) { dropIncomingAudio(s, size); return; }
+	}
 
-	const size_t limit = (s->maxBufferedBytes > 0) ? s->maxBufferedBytes : (size_t)(512 * 1024);
-
-	auto dropOneAudio = [&]() -> bool {
-		for (auto it = s->outQ.begin(); it != s->outQ.end(); ++it) {
-			if (it->type == BL_ITEM_AUDIO) {
-				size_t remaining = 0;
-				if (it->data.size() > it->offset) remaining = it->data.size() - it->offset;
-				if (s->queuedAudioBytes >= remaining) s->queuedAudioBytes -= remaining;
-				else s->queuedAudioBytes = 0;
-				s->outQ.erase(it);
-				return true;
-			}
+	// Copy straight from the engine's buffer into pooled blocks, one slot each.
+	const uint8_t* src = static_cast<const uint8_t*>(data);
+	size_t left = size;
+	while (left > 0) {
+		StreamItem* slot = s->outQ.pushSlot();
+		while (!slot) {
+			if (!dropOldestAudio(s)) { dropIncomingAudio(s, left); break; }
+			slot = s->outQ.pushSlot();
 		}
-		return false;
-	};
+		if (!slot) break;
 
-	// Avoid unbounded growth if consumer stalls for a long time.
-	while ((s->queuedAudioBytes + copied.size() > limit) || (s->outQ.size() >= s->maxQueueItems)) {
-		if (!dropOneAudio()) return;
+		uint8_t* block = s->audioPool.take();
+		while (!block) {
+			if (!dropOldestAudio(s)) { dropIncomingAudio(s, left); break; }
+			block = s->audioPool.take();
+		}
+		if (!block) break;
+
+		const size_t n = (left < AudioBlockPool::blockBytes) ? left : AudioBlockPool::blockBytes;
+		std::memcpy(block, src, n);
+		src += n;
+		left -= n;
+
+		slot->type = BL_ITEM_AUDIO;
+		slot->value = 0;
+		slot->gen = gen;
+		slot->data = block;
+		slot->size = n;
+		slot->offset = 0;
+
+		s->queuedAudioBytes.fetch_add(n, std::memory_order_relaxed);
+		s->outQ.commitPush();
 	}
-
-	StreamItem it(BL_ITEM_AUDIO, 0, gen);
-	it.data = std::move(copied);
-	it.offset = 0;
-
-	s->queuedAudioBytes += it.data.size();
-	s->outQ.push_back(std::move(it));
+	notifyReader(s);
 }
 
 static void pushMarker(BL_STATE* s, int type, int value, uint32_t gen) {
-	std::lock_guard<std::mutex> g(s->outMtx);
+	// Stamped even if a stop already gated the marker itself off.
+	if (type == BL_ITEM_DONE) {
+		markTime(s, gen, MARK_DONE, true);
+		s->finishedUtterances.fetch_add(1, std::memory_order_relaxed);
+	} else if (type == BL_ITEM_ERROR) {
+		markFlag(s, gen, BL_UTT_ERROR);
+	}
+
+	// BLOCK: wait for a free slot rather than drop audio to make one.
+	std::unique_lock<std::mutex> g(s->pushMtx);
+	while (s->overflowPolicy.load(std::memory_order_relaxed) == BL_OVERFLOW_BLOCK && !queueHasRoom(s, 0)) {
+		g.unlock();
+		if (!waitForQueueRoom(s, gen, 0)) return;
+		g.lock();
+	}
 	const uint32_t curGen = s->currentGen.load(std::memory_order_relaxed);
 	if (curGen == 0 || gen != curGen) return;
-	s->outQ.push_back(StreamItem(type, value, gen));
+
+	StreamItem* slot = s->outQ.pushSlot();
+	while (!slot) {
+		if (!dropOldestAudio(s)) return;
+		slot = s->outQ.pushSlot();
+	}
+
+	slot->type = type;
+	slot->value = value;
+	slot->gen = gen;
+	slot->data = nullptr;
+	slot->size = 0;
+	slot->offset = 0;
+	s->outQ.commitPush();
+	notifyReader(s);
 }
 
 static void __stdcall brailabDoneCallback() {
 	BL_STATE* s = g_state;
-	if (s && s->doneEvent) SetEvent(s->doneEvent);
+	if (!s) return;
+	markTime(s, s->activeGen.load(std::memory_order_relaxed), MARK_ENGINE_DONE, false);
+	if (s->doneEvent) SetEvent(s->doneEvent);
 }
 
 // ------------------------------------------------------------
@@ -475,6 +924,14 @@ static MMRESULT WINAPI hook_waveOutUnprepareHeader(HWAVEOUT hwo, LPWAVEHDR pwh,
 	return MMSYSERR_NOERROR;
 }
 
+// Hand a header back to the engine. Counted before WOM_DONE goes out, since
+// an engine may fire its done callback from inside that notification.
+static void completeHeader(BL_STATE* s, WAVEHDR* pwh) {
+	pwh->dwFlags |= WHDR_DONE;
+	s->hdrsCompleted.fetch_add(1, std::memory_order_release);
+	signalWaveOutMessage(s, WOM_DONE, pwh);
+}
+
 static MMRESULT WINAPI hook_waveOutWrite(HWAVEOUT hwo, LPWAVEHDR pwh, UINT cbwh) {
 	BL_STATE* s = g_state;
 	if (!s || !s->ttsModule || !isCallerFromModule(s->ttsModule)) {
@@ -482,6 +939,18 @@ static MMRESULT WINAPI hook_waveOutWrite(HWAVEOUT hwo, LPWAVEHDR pwh, UINT cbwh)
 	}
 
 	if (!pwh) return MMSYSERR_INVALPARAM;
+	s->hdrsWritten.fetch_add(1, std::memory_order_release);
+
+	// Lets the worker tell when a stopped engine is out of our waits.
+	struct InFlight {
+		BL_STATE* s;
+		explicit InFlight(BL_STATE* st) : s(st) { s->hooksInFlight.fetch_add(1, std::memory_order_acq_rel); }
+		~InFlight() {
+			if (s->hooksInFlight.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+			{ std::lock_guard<std::mutex> g(s->hooksIdleMtx); }
+			s->hooksIdleCv.notify_all();
+		}
+	} inFlight(s);
 
 	const uint32_t gen = s->activeGen.load(std::memory_order_relaxed);
 	const uint32_t curGen = s->currentGen.load(std::memory_order_relaxed);
@@ -494,54 +963,60 @@ static MMRESULT WINAPI hook_waveOutWrite(HWAVEOUT hwo, LPWAVEHDR pwh, UINT cbwh)
 
 	// If we are not capturing (e.g. canceled), don't throttle; finish immediately.
 	if (!capturing) {
-		pwh->dwFlags |= WHDR_DONE;
-		signalWaveOutMessage(s, WOM_DONE, pwh);
+		completeHeader(s, pwh);
+		return MMSYSERR_NOERROR;
+	}
+
+	// Offline render: the caller drains as fast as we fill, so don't pace at all.
+	if (s->renderMode.load(std::memory_order_relaxed)) {
+		completeHeader(s, pwh);
+		return MMSYSERR_NOERROR;
+	}
+
+	if (s->pacingMode.load(std::memory_order_relaxed) == BL_PACING_LOOKAHEAD) {
+		waitForLookahead(s, curGen);
+		completeHeader(s, pwh);
 		return MMSYSERR_NOERROR;
 	}
 
-	// Throttle so Brailab can't synthesize miles ahead of real time.
+	// BL_PACING_REALTIME: throttle so Brailab can't synthesize miles ahead of real time.
 	uint64_t bps = s->bytesPerSec.load(std::memory_order_relaxed);
 	if (bps == 0) bps = 22050;
 
-	uint32_t bufMs = (uint32_t)(((uint64_t)pwh->dwBufferLength * 1000ULL) / bps);
-	if (bufMs > 500) bufMs = 500; // sanity cap per buffer
+	uint64_t bufUs = ((uint64_t)pwh->dwBufferLength * 1000000ULL) / bps;
+	if (bufUs > 500000) bufUs = 500000; // sanity cap per buffer
 
 	// Warmup credit: allow first ~200ms to go through without sleeping (helps instant start).
-	uint32_t sleepMs = bufMs;
+	uint64_t sleepUs = bufUs;
+	const int bufMs = (int)(bufUs / 1000);
 	if (bufMs > 0) {
 		int credit = s->throttleCreditMs.load(std::memory_order_relaxed);
 		while (credit > 0) {
-			int use = (credit < (int)bufMs) ? credit : (int)bufMs;
+			int use = (credit < bufMs) ? credit : bufMs;
 			int expected = credit;
 			if (s->throttleCreditMs.compare_exchange_weak(expected, credit - use, std::memory_order_relaxed)) {
-				sleepMs = bufMs - (uint32_t)use;
+				sleepUs = bufUs - (uint64_t)use * 1000ULL;
 				break;
 			}
 			credit = s->throttleCreditMs.load(std::memory_order_relaxed);
 		}
 	}
 
-	if (sleepMs > 0) {
-		ULONGLONG end = GetTickCount64() + (ULONGLONG)sleepMs;
-		while (true) {
-			// abort early if canceled
-			if (s->activeGen.load(std::memory_order_relaxed) != curGen) break;
-
-			DWORD nowWait = 0;
-			ULONGLONG now = GetTickCount64();
-			if (now >= end) break;
-
-			ULONGLONG remain = end - now;
-			nowWait = (remain > 5) ? 5 : (DWORD)remain;
-
-			// wait on stopEvent so cancel is immediate
-			DWORD w = WaitForSingleObject(s->stopEvent, nowWait);
-			if (w == WAIT_OBJECT_0) break;
-		}
+	if (sleepUs > 0) {
+		// Absolute deadline on the high-resolution timer; stopEvent cuts it short.
+		// If we fell behind (or this is the first paced buffer), restart from
+		// now rather than trying to catch up.
+		const int64_t now = blNowUs();
+		int64_t deadline = s->paceDeadlineUs.load(std::memory_order_relaxed);
+		if (deadline < now) deadline = now;
+		deadline += (int64_t)sleepUs;
+		s->paceDeadlineUs.store(deadline, std::memory_order_relaxed);
+		// Stopped while we were copying: stopEvent may already be reset for the
+		// next utterance, so don't start a sleep nobody will cut short.
+		if (s->activeGen.load(std::memory_order_relaxed) == gen) s->paceTimer.waitUntil(deadline, s->stopEvent);
 	}
 
-	pwh->dwFlags |= WHDR_DONE;
-	signalWaveOutMessage(s, WOM_DONE, pwh);
+	completeHeader(s, pwh);
 	return MMSYSERR_NOERROR;
 }
 
@@ -582,6 +1057,147 @@ static void ensureHooksInstalled() {
 // ------------------------------------------------------------
 // Worker loop
 // ------------------------------------------------------------
+// Fallback tail-grace: wait until no new audio has arrived for ~30ms (max
+// 250ms). Returns false if stopped meanwhile.
+static bool waitForTailGrace(BL_STATE* s) {
+	const int64_t graceEnd = blNowUs() + 250000;
+	while (true) {
+		const int64_t last = s->lastAudioUs.load(std::memory_order_relaxed);
+		const int64_t now = blNowUs();
+
+		if (last != 0 && (now - last) >= 30000) return true;
+		if (now >= graceEnd) return true;
+
+		// Sleep exactly until the quiet period would be over; with no audio yet
+		// there's nothing to aim at, so look again shortly.
+		int64_t until = (last != 0) ? last + 30000 : now + 5000;
+		if (until > graceEnd) until = graceEnd;
+		if (!s->graceTimer.waitUntil(until, s->stopEvent)) return false;
+	}
+}
+
+// After the done callback: is the chunk over? Normally settled at once, since
+// every header the engine wrote has come back and none is in flight. The
+// quiet-period timing only covers a chunk that wrote no audio at all.
+// Returns false if stopped meanwhile.
+static bool waitForChunkEnd(BL_STATE* s, uint32_t writtenAtStart) {
+	int64_t last = blNowUs();
+	int64_t engineUs = 0;
+	while (true) {
+		const uint32_t completed = s->hdrsCompleted.load(std::memory_order_acquire);
+		const uint32_t written = s->hdrsWritten.load(std::memory_order_acquire);
+		if (written == writtenAtStart) return waitForTailGrace(s);
+		if (written == completed) return true;
+
+		// A header is still inside waveOutWrite; it comes back shortly. One
+		// parked on the reader (BLOCK/LOOKAHEAD) may hold audio not queued yet,
+		// so that time doesn't count toward the 250 ms: wait for it instead.
+		const int64_t now = blNowUs();
+		const bool parked = s->hooksParked.load(std::memory_order_acquire) > 0;
+		if (!parked) engineUs += now - last;
+		last = now;
+		if (engineUs >= 250000) return true;
+		if (!s->graceTimer.waitUntil(now + (parked ? 10000 : 1000), s->stopEvent)) return false;
+	}
+}
+
+// A composite utterance gave way to a priority one at part `at`. If that
+// priority command asked for it, queue the rest (from the last index marker
+// reached) at the head of the normal lane so it resumes right after.
+static void requeuePreempted(BL_STATE* s, const Cmd& cmd, size_t at, uint32_t snap) {
+	std::lock_guard<std::mutex> lk(s->cmdMtx);
+	const Cmd* next = s->cmdQ.peek(LANE_PRIORITY);
+	if (s->quitting || !next || !next->resumeAfter) return;
+
+	const size_t from = resumePoint(cmd.parts, at, [](const CmdPart& p) { return p.kind == CmdPart::PART_INDEX; });
+
+	Cmd rest;
+	rest.type = Cmd::CMD_UTTERANCE;
+	rest.cancelSnapshot = snap; // a bl_stop in between drops it like anything else queued
+	rest.noIntonation = cmd.noIntonation;
+	rest.parts.assign(cmd.parts.begin() + (std::ptrdiff_t)from, cmd.parts.end());
+	rest.enqueuedUs = blNowUs();
+	rest.lane = LANE_NORMAL;
+	s->cmdQ.pushFront(std::move(rest), LANE_NORMAL);
+}
+
+// ------------------------------------------------------------
+// Watchdog (rules in bl_watchdog.h)
+// ------------------------------------------------------------
+enum EngineWait {
+	ENGINE_FINISHED = 0, // done callback
+	ENGINE_STOPPED,      // bl_stop / cancel
+	ENGINE_TIMEOUT,      // BL_ENGINE_TIMEOUT
+	ENGINE_STALLED       // BL_ENGINE_STALLED
+};
+
+// Worker, after a chunk finished normally: fold its audio time per character
+// into the estimate.
+static void learnSpeechRate(BL_STATE* s, size_t chars, uint64_t capturedAtStart) {
+	s->speechRate.learn(chars, s->capturedBytes.load(std::memory_order_relaxed) - capturedAtStart,
+		s->bytesPerSec.load(std::memory_order_relaxed), s->desiredTempo.load(std::memory_order_relaxed));
+}
+
+// Worker, after StartSay: wait for the done callback, a stop, or a hang.
+static EngineWait waitForEngine(BL_STATE* s, uint32_t snap, size_t chars) {
+	BlEngineWatch watch(s->speechRate.budgetUs(chars, s->desiredTempo.load(std::memory_order_relaxed)),
+		blNowUs(), s->hdrsWritten.load(std::memory_order_relaxed));
+
+	HANDLE waits[2] = { s->doneEvent, s->stopEvent };
+	while (true) {
+		const DWORD w = WaitForMultipleObjects(2, waits, FALSE, 50);
+		if (w == WAIT_OBJECT_0) return ENGINE_FINISHED;
+		if (w == WAIT_OBJECT_0 + 1) return ENGINE_STOPPED;
+		if (s->cancelToken.load(std::memory_order_relaxed) != snap) return ENGINE_STOPPED;
+
+		const BlEngineVerdict v = watch.poll(blNowUs(), s->hdrsWritten.load(std::memory_order_relaxed),
+			s->hooksInFlight.load(std::memory_order_acquire) > 0);
+		if (v == BL_ENGINE_TIMEOUT) return ENGINE_TIMEOUT;
+		if (v == BL_ENGINE_STALLED) return ENGINE_STALLED;
+	}
+}
+
+// Worker: the engine hung. Stop it and run TTS_Init again so the next
+// utterance gets a fresh start instead of queueing behind the hang.
+static void recycleEngine(BL_STATE* s) {
+	std::lock_guard<std::mutex> tg(s->ttsMtx);
+	seh_ttsStop(s->ttsStop);
+	seh_ttsInit(s->ttsInit, s->initValue, brailabDoneCallback);
+}
+
+// Worker: wait (bounded) until no engine thread is inside hook_waveOutWrite.
+// While stopEvent is set every wait in there returns at once, so this is
+// normally a few microseconds; it keeps the next utterance from resetting
+// stopEvent under a hook still sleeping for the stopped one.
+static bool waitForHooksIdle(BL_STATE* s, int64_t timeoutUs) {
+	if (s->hooksInFlight.load(std::memory_order_acquire) == 0) return true;
+	std::unique_lock<std::mutex> lk(s->hooksIdleMtx);
+	return s->hooksIdleCv.wait_for(lk, std::chrono::microseconds(timeoutUs), [&]() {
+		return s->hooksInFlight.load(std::memory_order_acquire) == 0;
+	});
+}
+
+// Worker, after an utterance was cut short: make sure the engine is quiet and,
+// if bl_stop asked for it, record how long that took.
+static void settleAfterStop(BL_STATE* s, int64_t engineStoppedUs) {
+	waitForHooksIdle(s, 50000);
+	const int64_t req = s->stopRequestUs.exchange(0, std::memory_order_relaxed);
+	if (req == 0) return; // watchdog or engine error, not a bl_stop
+
+	const int64_t now = blNowUs();
+	auto rel = [&](int64_t t) -> int32_t {
+		const int64_t d = t - req;
+		if (d < 0) return 0;
+		return (d > INT_MAX) ? INT_MAX : (int32_t)d;
+	};
+
+	std::lock_guard<std::mutex> g(s->stopStatsMtx);
+	const uint32_t slot = s->stopsMeasured % BL_STATS_HISTORY;
+	s->stopEngineUs[slot] = rel(engineStoppedUs ? engineStoppedUs : req);
+	s->stopIdleUs[slot] = rel(now);
+	++s->stopsMeasured;
+}
+
 static void workerLoop(BL_STATE* s) {
 	if (!s) return;
 
@@ -596,8 +1212,8 @@ static void workerLoop(BL_STATE* s) {
 			s->cmdCv.wait(lk, [&]() { return s->quitting || !s->cmdQ.empty(); });
 			if (s->quitting) return;
 
-			cmd = std::move(s->cmdQ.front());
-			s->cmdQ.pop_front();
+			s->cmdQ.pop(cmd);
+			if (cmd.lane == LANE_PRIORITY) s->priorityQueued.fetch_sub(1, std::memory_order_relaxed);
 		}
 
 		if (cmd.type == Cmd::CMD_QUIT) return;
@@ -606,26 +1222,57 @@ static void workerLoop(BL_STATE* s) {
 		if (cmd.cancelSnapshot != snap) continue;
 
 		const uint32_t gen = s->genCounter.fetch_add(1, std::memory_order_relaxed);
+		beginTimes(s, gen, cmd.enqueuedUs);
 
-		// reset events for this utterance
+		// reset events for this utterance. A bl_stop that arrived while idle
+		// had nothing to cut short, so it isn't a latency sample.
+		waitForHooksIdle(s, 50000);
+		s->stopRequestUs.store(0, std::memory_order_relaxed);
 		ResetEvent(s->stopEvent);
 		ResetEvent(s->doneEvent);
 
-		// allow first 200ms to generate without sleeping (helps instant start)
-		s->throttleCreditMs.store(200, std::memory_order_relaxed);
+		// Pacing budget: bl_setLookaheadMs changes take effect here.
+		// Burst: allow the first N ms to generate without sleeping (helps instant start).
+		s->throttleCreditMs.store(s->desiredBurstMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		s->lookaheadMs.store((uint32_t)s->desiredLookaheadMs.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		{
+			const int maxMs = s->desiredMaxBufferedMs.load(std::memory_order_relaxed);
+			if (maxMs != s->maxBufferedMs.load(std::memory_order_relaxed)) {
+				s->maxBufferedMs.store(maxMs, std::memory_order_relaxed);
+				computeBufferLimits(s);
+			}
+		}
 
 		// gate on
 		s->currentGen.store(gen, std::memory_order_relaxed);
 		s->activeGen.store(gen, std::memory_order_relaxed);
-		s->lastAudioTick.store(0, std::memory_order_relaxed);
+		s->lastAudioUs.store(0, std::memory_order_relaxed);
+		s->paceDeadlineUs.store(0, std::memory_order_relaxed);
 
-		// clear output
-		{
-			std::lock_guard<std::mutex> g(s->outMtx);
-			clearOutputQueueLocked(s);
-		}
+		// No clear here: what's still queued is either the previous utterance's
+		// tail, which plays first, or from a stopped one, which the reader drops
+		// (back into audioPool) on its next read.
+
+		// A dictionary loaded (or unloaded) since the last utterance takes over
+		// here; the one it replaces is no longer in use.
+		if (BlDictionary* d = s->dictPending.exchange(nullptr, std::memory_order_acquire)) s->dict.reset(d);
 
 		// Composite utterance: multiple text chunks + index markers, single DONE at end.
+		const unsigned normFlags = s->normalizeFlags.load(std::memory_order_relaxed);
+
+		// A plain speak too long for one StartSay, as given or once the
+		// dictionary and normalization are done with it, runs as a composite of
+		// chunks instead (still one DONE). It stays a CMD_SPEAK until here, so
+		// coalescing treats it like any other speak while it waits.
+		std::wstring safe;
+		if (cmd.type == Cmd::CMD_SPEAK) {
+			safe = prepareSpeechText(s, cmd.text, normFlags);
+			if (safe.size() > kChunkMaxChars) {
+				cmd.type = Cmd::CMD_UTTERANCE;
+				for (std::wstring& chunk : blChunkText(safe)) cmd.parts.push_back(CmdPart::Ready(std::move(chunk)));
+			}
+		}
+
 		if (cmd.type == Cmd::CMD_UTTERANCE) {
 			// Apply settings ON THIS THREAD (fixes TLS/thread-affinity engines).
 			{
@@ -638,31 +1285,77 @@ static void workerLoop(BL_STATE* s) {
 			bool anyWork = false;
 			bool stopped = false;
 
-			for (const auto& part : cmd.parts) {
+			// Pipelining: the next text part is prepared (dictionary, normalization,
+			// sanitizing, splitting) while the engine synthesizes this one, so its
+			// StartSay goes out as soon as done lands. The engine itself still
+			// speaks one part at a time.
+			// Preparing splits a part that is too long for one StartSay (as added,
+			// or once the dictionary and normalization are done), which inserts
+			// parts after it: don't hold references or pointers into
+			// cmd.parts across it.
+			auto prepare = [&](size_t i) {
+				CmdPart& p = cmd.parts[i];
+				if (p.kind != CmdPart::PART_TEXT || p.ready) return;
+				std::wstring safe = prepareSpeechText(s, p.text, normFlags);
+				p.ready = true;
+				if (safe.size() <= kChunkMaxChars) {
+					p.text = std::move(safe);
+					return;
+				}
+				std::vector<std::wstring> chunks = blChunkText(safe);
+				p.text = std::move(chunks[0]);
+				std::vector<CmdPart> more;
+				for (size_t k = 1; k < chunks.size(); ++k) more.push_back(CmdPart::Ready(std::move(chunks[k])));
+				cmd.parts.insert(cmd.parts.begin() + (std::ptrdiff_t)(i + 1),
+					std::make_move_iterator(more.begin()), std::make_move_iterator(more.end()));
+			};
+			auto prepareNextText = [&](size_t i) {
+				for (size_t j = i + 1; j < cmd.parts.size(); ++j) {
+					if (cmd.parts[j].kind == CmdPart::PART_TEXT) { prepare(j); return; }
+				}
+			};
+
+			size_t preemptAt = 0; // part where a priority utterance cut in (0 = didn't)
+			int64_t engineStoppedUs = 0;
+
+			for (size_t i = 0; i < cmd.parts.size(); ++i) {
 				if (WaitForSingleObject(s->stopEvent, 0) == WAIT_OBJECT_0) { stopped = true; break; }
 				if (s->cancelToken.load(std::memory_order_relaxed) != snap) { stopped = true; break; }
 
-				if (part.kind == CmdPart::PART_INDEX) {
-					pushMarker(s, BL_ITEM_INDEX, part.index, gen);
+				// Part boundary: a waiting priority utterance takes over here.
+				if (i > 0 && cmd.lane == LANE_NORMAL && s->priorityQueued.load(std::memory_order_relaxed) > 0) {
+					preemptAt = i;
+					break;
+				}
+
+				if (cmd.parts[i].kind == CmdPart::PART_INDEX) {
+					pushMarker(s, BL_ITEM_INDEX, cmd.parts[i].index, gen);
 					anyWork = true;
 					continue;
 				}
 
-				std::wstring safePart = sanitizeForBrailab(part.text.c_str());
-				if (safePart.empty()) continue;
+				prepare(i);
+				// StartSay reads from a copy: preparing the next part while the
+				// engine speaks may insert into cmd.parts and move this one.
+				const std::wstring sayText = cmd.parts[i].text;
+				if (sayText.empty()) continue;
+				const size_t partChars = sayText.size();
 				anyWork = true;
 
 				// Reset doneEvent per chunk (manual-reset event).
 				ResetEvent(s->doneEvent);
-				s->lastAudioTick.store(0, std::memory_order_relaxed);
+				s->lastAudioUs.store(0, std::memory_order_relaxed);
 
+				const uint32_t writtenAtStart = s->hdrsWritten.load(std::memory_order_relaxed);
+				const uint64_t capturedAtStart = s->capturedBytes.load(std::memory_order_relaxed);
 				int startOk = 0;
+				markTime(s, gen, MARK_START_SAY, true);
 				{
 					std::lock_guard<std::mutex> tg(s->ttsMtx);
 					if (cmd.noIntonation && s->ttsStartSayNoIntonationW) {
-						startOk = seh_ttsStartSayNoIntW(s->ttsStartSayNoIntonationW, safePart.c_str());
+						startOk = seh_ttsStartSayNoIntW(s->ttsStartSayNoIntonationW, sayText.c_str());
 					} else {
-						startOk = seh_ttsStartSayW(s->ttsStartSayW, safePart.c_str());
+						startOk = seh_ttsStartSayW(s->ttsStartSayW, sayText.c_str());
 					}
 				}
 
@@ -673,75 +1366,53 @@ static void workerLoop(BL_STATE* s) {
 					break;
 				}
 
-				// Wait for done or stop/cancel, with watchdog
-				const auto t0 = std::chrono::steady_clock::now();
-				const auto maxDur = std::chrono::seconds(180);
-				HANDLE waits[2] = { s->doneEvent, s->stopEvent };
-
-				while (true) {
-					DWORD w = WaitForMultipleObjects(2, waits, FALSE, 50);
+				// Engine is busy with this part: get the next one ready meanwhile.
+				prepareNextText(i);
 
-					if (w == WAIT_OBJECT_0) {
-						// doneEvent
-						break;
-					}
-					if (w == WAIT_OBJECT_0 + 1) {
-						stopped = true;
-						break;
-					}
-
-					if (s->cancelToken.load(std::memory_order_relaxed) != snap) {
-						stopped = true;
-						break;
-					}
-
-					if (std::chrono::steady_clock::now() - t0 > maxDur) {
-						pushMarker(s, BL_ITEM_ERROR, 1002, gen);
-						stopped = true;
-						break;
-					}
-				}
-
-				if (stopped) {
-					// Stop inside worker thread (TLS-safe)
-					{
+				// Wait for done or stop/cancel, with watchdog
+				const EngineWait ew = waitForEngine(s, snap, partChars);
+				if (ew != ENGINE_FINISHED) {
+					if (ew == ENGINE_STOPPED) {
+						// Stop inside worker thread (TLS-safe)
 						std::lock_guard<std::mutex> tg(s->ttsMtx);
 						seh_ttsStop(s->ttsStop);
+					} else {
+						pushMarker(s, BL_ITEM_ERROR, (ew == ENGINE_TIMEOUT) ? kWatchdogTimeoutError : kWatchdogStallError, gen);
+						recycleEngine(s);
 					}
+					engineStoppedUs = blNowUs();
+					stopped = true;
 					break;
 				}
 
-				// Small tail-grace: wait until no new audio has arrived for ~30ms (max 250ms)
-				ULONGLONG graceStart = GetTickCount64();
-				while (true) {
-					ULONGLONG last = s->lastAudioTick.load(std::memory_order_relaxed);
-					ULONGLONG now = GetTickCount64();
-
-					if (last != 0 && (now - last) >= 30) break;
-					if ((now - graceStart) >= 250) break;
-
-					// allow cancel
-					if (WaitForSingleObject(s->stopEvent, 5) == WAIT_OBJECT_0) { stopped = true; break; }
-					if (s->cancelToken.load(std::memory_order_relaxed) != snap) { stopped = true; break; }
-				}
+				if (!waitForChunkEnd(s, writtenAtStart) || s->cancelToken.load(std::memory_order_relaxed) != snap) stopped = true;
+				else learnSpeechRate(s, partChars, capturedAtStart);
 				if (stopped) {
 					{
 						std::lock_guard<std::mutex> tg(s->ttsMtx);
 						seh_ttsStop(s->ttsStop);
 					}
+					engineStoppedUs = blNowUs();
 					break;
 				}
 			}
 
 			// gate off BEFORE DONE marker so no audio appears after DONE
 			s->activeGen.store(0, std::memory_order_relaxed);
+			if (stopped) settleAfterStop(s, engineStoppedUs);
+
+			if (preemptAt > 0) {
+				requeuePreempted(s, cmd, preemptAt, snap);
+				markFlag(s, gen, BL_UTT_PREEMPTED);
+				pushMarker(s, BL_ITEM_DONE, BL_DONE_PREEMPTED, gen);
+				continue;
+			}
 
 			// If we aborted (stop/cancel), we still emit DONE so reader doesn't wait forever.
 			pushMarker(s, BL_ITEM_DONE, 0, gen);
 			continue;
 		}
 
-		std::wstring safe = sanitizeForBrailab(cmd.text.c_str());
 		if (safe.empty()) {
 			s->activeGen.store(0, std::memory_order_relaxed);
 			pushMarker(s, BL_ITEM_DONE, 0, gen);
@@ -757,7 +1428,10 @@ static void workerLoop(BL_STATE* s) {
 		}
 
 		// Start speech (SEH safe)
+		const uint32_t writtenAtStart = s->hdrsWritten.load(std::memory_order_relaxed);
+		const uint64_t capturedAtStart = s->capturedBytes.load(std::memory_order_relaxed);
 		int startOk = 0;
+		markTime(s, gen, MARK_START_SAY, true);
 		{
 			std::lock_guard<std::mutex> tg(s->ttsMtx);
 			if (cmd.noIntonation && s->ttsStartSayNoIntonationW) {
@@ -775,60 +1449,25 @@ static void workerLoop(BL_STATE* s) {
 		}
 
 		// Wait for done or stop/cancel, with watchdog
-		const auto t0 = std::chrono::steady_clock::now();
-		const auto maxDur = std::chrono::seconds(180);
-
-		HANDLE waits[2] = { s->doneEvent, s->stopEvent };
-
-		bool stopped = false;
-		while (true) {
-			DWORD w = WaitForMultipleObjects(2, waits, FALSE, 50);
-
-			if (w == WAIT_OBJECT_0) {
-				// doneEvent
-				break;
-			}
-			if (w == WAIT_OBJECT_0 + 1) {
-				stopped = true;
-				break;
-			}
+		const EngineWait ew = waitForEngine(s, snap, safe.size());
 
-			if (s->cancelToken.load(std::memory_order_relaxed) != snap) {
-				stopped = true;
-				break;
-			}
-
-			if (std::chrono::steady_clock::now() - t0 > maxDur) {
-				pushMarker(s, BL_ITEM_ERROR, 1002, gen);
-				stopped = true;
-				break;
-			}
-		}
-
-		if (stopped) {
-			// Stop inside worker thread (again: TLS-safe)
-			{
+		if (ew != ENGINE_FINISHED) {
+			if (ew == ENGINE_STOPPED) {
+				// Stop inside worker thread (again: TLS-safe)
 				std::lock_guard<std::mutex> tg(s->ttsMtx);
 				seh_ttsStop(s->ttsStop);
+			} else {
+				pushMarker(s, BL_ITEM_ERROR, (ew == ENGINE_TIMEOUT) ? kWatchdogTimeoutError : kWatchdogStallError, gen);
+				recycleEngine(s);
 			}
 			s->activeGen.store(0, std::memory_order_relaxed);
+			settleAfterStop(s, blNowUs());
 			// we still emit DONE so the reader doesn’t wait forever
 			pushMarker(s, BL_ITEM_DONE, 0, gen);
 			continue;
 		}
 
-		// Small tail-grace: wait until no new audio has arrived for ~30ms (max 250ms)
-		ULONGLONG graceStart = GetTickCount64();
-		while (true) {
-			ULONGLONG last = s->lastAudioTick.load(std::memory_order_relaxed);
-			ULONGLONG now = GetTickCount64();
-
-			if (last != 0 && (now - last) >= 30) break;
-			if ((now - graceStart) >= 250) break;
-
-			// allow cancel
-			if (WaitForSingleObject(s->stopEvent, 5) == WAIT_OBJECT_0) break;
-		}
+		if (waitForChunkEnd(s, writtenAtStart)) learnSpeechRate(s, safe.size(), capturedAtStart);
 
 		// gate off BEFORE DONE marker so no audio appears after DONE
 		s->activeGen.store(0, std::memory_order_relaxed);
@@ -878,6 +1517,7 @@ extern "C" BL_API BL_STATE* __cdecl bl_initW(const wchar_t* ttsDllPath, int init
 
 	{
 		std::lock_guard<std::mutex> tg(s->ttsMtx);
+		s->initValue = initValue;
 		if (!seh_ttsInit(s->ttsInit, initValue, brailabDoneCallback)) {
 			g_state = nullptr;
 			CloseHandle(s->doneEvent);
@@ -905,6 +1545,10 @@ extern "C" BL_API BL_STATE* __cdecl bl_initW(const wchar_t* ttsDllPath, int init
 	return s;
 }
 
+extern "C" BL_API int __cdecl bl_getFeatures(void) {
+	return BL_FEATURE_CHUNKING;
+}
+
 extern "C" BL_API void __cdecl bl_free(BL_STATE* s) {
 	if (!s) return;
 
@@ -915,28 +1559,41 @@ extern "C" BL_API void __cdecl bl_free(BL_STATE* s) {
 
 	s->activeGen.store(0, std::memory_order_relaxed);
 	s->currentGen.store(0, std::memory_order_relaxed);
+	wakeReaders(s);
+	wakeCaptureThread(s);
 
 	{
 		std::lock_guard<std::mutex> lk(s->cmdMtx);
 		s->quitting = true;
 		s->cmdQ.clear();
+		s->priorityQueued.store(0, std::memory_order_relaxed);
 	}
 	s->cmdCv.notify_all();
 	if (s->worker.joinable()) s->worker.join();
 
+	{
+		std::lock_guard<std::mutex> lk(s->sinkMtx);
+		s->sinkQuit = true;
+		s->sink = nullptr;
+	}
+	s->sinkCv.notify_all();
+	wakeSink(s);
+	if (s->sinkThread.joinable()) s->sinkThread.join();
+
 	{
 		std::lock_guard<std::mutex> tg(s->ttsMtx);
 		seh_ttsStop(s->ttsStop);
 	}
 
 	{
-		std::lock_guard<std::mutex> g(s->outMtx);
+		std::lock_guard<std::mutex> g(s->readMtx);
 		clearOutputQueueLocked(s);
 	}
 
 	if (s->doneEvent) CloseHandle(s->doneEvent);
 	if (s->stopEvent) CloseHandle(s->stopEvent);
 	if (s->ttsModule) FreeLibrary(s->ttsModule);
+	delete s->dictPending.exchange(nullptr);
 
 	if (g_state == s) g_state = nullptr;
 	delete s;
@@ -946,22 +1603,70 @@ extern "C" BL_API void __cdecl bl_stop(BL_STATE* s) {
 	if (!s) return;
 
 	s->cancelToken.fetch_add(1, std::memory_order_relaxed);
-
-	// gate off and clear queue
+	int64_t noRequest = 0;
+	s->stopRequestUs.compare_exchange_strong(noRequest, blNowUs(), std::memory_order_relaxed);
+
+	// Raising minLiveGen past every gen handed out so far invalidates everything
+	// queued in O(1); the blocks are reclaimed later by whoever next touches the
+	// queue (the reader, or a starved producer), never here on the caller's
+	// keystroke path. Then gate off.
+	s->minLiveGen.store(s->genCounter.load());
 	s->activeGen.store(0, std::memory_order_relaxed);
-	s->currentGen.store(0, std::memory_order_relaxed);
-
+	markFlag(s, s->currentGen.exchange(0, std::memory_order_relaxed), BL_UTT_STOPPED);
 	{
-		std::lock_guard<std::mutex> g(s->outMtx);
-		clearOutputQueueLocked(s);
+		// Same trick for a reader in another process.
+		std::lock_guard<std::mutex> g(s->shmMtx);
+		if (s->shmOut) s->shmOut->invalidate();
 	}
 
-	// wake worker + hook throttles
+	// wake worker + hook throttles + parked readers/capture
 	SetEvent(s->stopEvent);
 	SetEvent(s->doneEvent);
+	wakeReaders(s);
+	wakeCaptureThread(s);
+}
+
+static bool isPlainSpeak(const Cmd& c) { return c.type == Cmd::CMD_SPEAK && !c.noCoalesce; }
+
+// cmdMtx held. Drops and merges only touch commands still waiting, so the one
+// the worker is speaking is never affected.
+static void queueCommandLocked(BL_STATE* s, Cmd&& cmd, int flags) {
+	cmd.lane = (flags & BL_SPEAK_PRIORITY) ? LANE_PRIORITY : LANE_NORMAL;
+	cmd.resumeAfter = (flags & BL_SPEAK_RESUME) != 0;
+	const int lane = cmd.lane;
+	size_t dropped = 0;
+
+	if (isPlainSpeak(cmd) && s->coalesceMode == BL_COALESCE_LATEST) {
+		dropped += s->cmdQ.removeIf(lane, isPlainSpeak);
+	} else if (isPlainSpeak(cmd) && s->coalesceMode == BL_COALESCE_MERGE) {
+		Cmd* tail = s->cmdQ.back(lane);
+		if (tail && isPlainSpeak(*tail) && tail->noIntonation == cmd.noIntonation &&
+			tail->cancelSnapshot == cmd.cancelSnapshot && tail->resumeAfter == cmd.resumeAfter) {
+			// Keeps the tail's enqueuedUs: latency stats count from the oldest keystroke.
+			tail->text += L' ';
+			tail->text += cmd.text;
+			++s->coalescedMerged;
+			return;
+		}
+	}
+
+	if (lane == LANE_PRIORITY) s->priorityQueued.fetch_add(1, std::memory_order_relaxed);
+	s->cmdQ.push(std::move(cmd), lane);
+
+	if (s->coalesceMaxDepth > 0) {
+		dropped += s->cmdQ.trimOldest(lane, (size_t)s->coalesceMaxDepth, isPlainSpeak);
+	}
+	if (dropped) {
+		s->coalescedDropped += (uint32_t)dropped;
+		if (lane == LANE_PRIORITY) s->priorityQueued.fetch_sub((int)dropped, std::memory_order_relaxed);
+	}
 }
 
 extern "C" BL_API int __cdecl bl_startSpeakW(BL_STATE* s, const wchar_t* text, int noIntonation) {
+	return bl_startSpeakExW(s, text, noIntonation, 0);
+}
+
+extern "C" BL_API int __cdecl bl_startSpeakExW(BL_STATE* s, const wchar_t* text, int noIntonation, int flags) {
 	if (!s || !text) return 1;
 
 	Cmd cmd;
@@ -969,10 +1674,11 @@ extern "C" BL_API int __cdecl bl_startSpeakW(BL_STATE* s, const wchar_t* text, i
 	cmd.cancelSnapshot = s->cancelToken.load(std::memory_order_relaxed);
 	cmd.text = text;
 	cmd.noIntonation = (noIntonation != 0);
+	cmd.enqueuedUs = blNowUs();
 
 	{
 		std::lock_guard<std::mutex> lk(s->cmdMtx);
-		s->cmdQ.push_back(std::move(cmd));
+		queueCommandLocked(s, std::move(cmd), flags);
 	}
 	s->cmdCv.notify_one();
 	return 0;
@@ -991,6 +1697,8 @@ extern "C" BL_API int __cdecl bl_addTextUtteranceW(BL_STATE* s, const wchar_t* t
 	if (!s || !text) return 1;
 	std::lock_guard<std::mutex> lk(s->cmdMtx);
 	if (!s->buildActive) return 2;
+	// Long text is split by the worker, once the dictionary has seen it
+	// whole: a multi-word key could straddle a split made here.
 	s->buildParts.push_back(CmdPart::Text(text));
 	return 0;
 }
@@ -1004,11 +1712,16 @@ extern "C" BL_API int __cdecl bl_addIndexUtterance(BL_STATE* s, int index) {
 }
 
 extern "C" BL_API int __cdecl bl_commitUtterance(BL_STATE* s) {
+	return bl_commitUtteranceEx(s, 0);
+}
+
+extern "C" BL_API int __cdecl bl_commitUtteranceEx(BL_STATE* s, int flags) {
 	if (!s) return 1;
 
 	Cmd cmd;
 	cmd.type = Cmd::CMD_UTTERANCE;
 	cmd.cancelSnapshot = s->cancelToken.load(std::memory_order_relaxed);
+	cmd.enqueuedUs = blNowUs();
 
 	{
 		std::lock_guard<std::mutex> lk(s->cmdMtx);
@@ -1020,7 +1733,7 @@ extern "C" BL_API int __cdecl bl_commitUtterance(BL_STATE* s) {
 		s->buildParts.clear();
 		s->buildActive = false;
 
-		s->cmdQ.push_back(std::move(cmd));
+		queueCommandLocked(s, std::move(cmd), flags);
 	}
 
 	s->cmdCv.notify_one();
@@ -1032,56 +1745,601 @@ extern "C" BL_API int __cdecl bl_read(BL_STATE* s, int* outType, int* outValue,
 	if (outValue) *outValue = 0;
 	if (!s || !outAudio || outCap < 0) return 0;
 
-	std::lock_guard<std::mutex> g(s->outMtx);
+	std::lock_guard<std::mutex> g(s->readMtx);
+
+	StreamItem* front = readableFrontLocked(s);
+	if (!front) return 0;
+
+	if (outType) *outType = front->type;
+	if (outValue) *outValue = front->value;
+
+	if (front->type == BL_ITEM_AUDIO) {
+		// Audio of one utterance comes out as one run, however many blocks it
+		// was queued in, up to outCap.
+		const uint32_t gen = front->gen;
+		int n = 0;
+		while (front && front->type == BL_ITEM_AUDIO && front->gen == gen) {
+			const size_t remainingSz = (front->size > front->offset) ? (front->size - front->offset) : 0;
+			const size_t room = (size_t)(outCap - n);
+			const size_t take = (remainingSz < room) ? remainingSz : room;
+
+			if (take > 0) {
+				std::memcpy(outAudio + n, front->data + front->offset, take);
+				front->offset += take;
+				releaseQueuedAudio(s, take);
+				n += (int)take;
+			}
 
-	const uint32_t curGen = s->currentGen.load(std::memory_order_relaxed);
-	if (curGen == 0) {
-		clearOutputQueueLocked(s);
-		return 0;
+			if (front->offset < front->size) break;
+			popOutputItemLocked(s);
+			front = readableFrontLocked(s);
+		}
+		return n;
+	}
+
+	// DONE/ERROR
+	popOutputItemLocked(s);
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_readMany(BL_STATE* s, BL_READ_ITEM* items, int maxItems, uint8_t* audio, int audioCap, int* outAudioBytes) {
+	if (outAudioBytes) *outAudioBytes = 0;
+	if (!s || !items || maxItems <= 0 || audioCap < 0) return 0;
+
+	std::lock_guard<std::mutex> g(s->readMtx);
+
+	int count = 0;
+	int used = 0;
+
+	while (true) {
+		StreamItem* front = readableFrontLocked(s);
+		if (!front) break;
+
+		if (front->type == BL_ITEM_AUDIO) {
+			size_t remainingSz = (front->size > front->offset) ? (front->size - front->offset) : 0;
+			if (remainingSz == 0) {
+				popOutputItemLocked(s);
+				continue;
+			}
+
+			const int room = audioCap - used;
+			if (!audio || room <= 0) break;
+
+			// Back-to-back audio blocks share one descriptor: the buffer is contiguous.
+			BL_READ_ITEM* d = (count > 0 && items[count - 1].type == BL_ITEM_AUDIO) ? &items[count - 1] : nullptr;
+			if (!d) {
+				if (count >= maxItems) break;
+				d = &items[count++];
+				d->type = BL_ITEM_AUDIO;
+				d->audioOffset = used;
+				d->audioLen = 0;
+			}
+
+			int n = (remainingSz > (size_t)room) ? room : (int)remainingSz;
+			std::memcpy(audio + used, front->data + front->offset, (size_t)n);
+			front->offset += (size_t)n;
+			releaseQueuedAudio(s, (size_t)n);
+
+			used += n;
+			d->audioLen += n;
+			d->value = d->audioLen;
+
+			if (front->offset >= front->size) popOutputItemLocked(s);
+			continue;
+		}
+
+		if (count >= maxItems) break;
+		BL_READ_ITEM* d = &items[count++];
+		d->type = front->type;
+		d->value = front->value;
+		d->audioOffset = used;
+		d->audioLen = 0;
+		popOutputItemLocked(s);
+
+		// Leave whatever follows DONE/ERROR for the next call: it belongs to the next utterance.
+		if (d->type == BL_ITEM_DONE || d->type == BL_ITEM_ERROR) break;
+	}
+
+	if (outAudioBytes) *outAudioBytes = used;
+	return count;
+}
+
+extern "C" BL_API int __cdecl bl_readWait(BL_STATE* s, int timeoutMs, int* outType, int* outValue, uint8_t* outAudio, int outCap) {
+	if (outType) *outType = BL_ITEM_NONE;
+	if (outValue) *outValue = 0;
+	if (!s || outCap < 0) return 0;
+
+	const bool forever = (timeoutMs < 0);
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(forever ? 0 : timeoutMs);
+
+	uint32_t wakeSeq;
+	{
+		std::lock_guard<std::mutex> g(s->waitMtx);
+		wakeSeq = s->readWakeSeq;
 	}
 
-	// drop stale items
-	while (!s->outQ.empty() && s->outQ.front().gen != curGen) {
-		StreamItem& it = s->outQ.front();
-		if (it.type == BL_ITEM_AUDIO) {
-			size_t remaining = (it.data.size() > it.offset) ? (it.data.size() - it.offset) : 0;
-			if (s->queuedAudioBytes >= remaining) s->queuedAudioBytes -= remaining;
-			else s->queuedAudioBytes = 0;
+	while (true) {
+		if (outAudio) {
+			int type = BL_ITEM_NONE;
+			int n = bl_read(s, &type, outValue, outAudio, outCap);
+			if (type != BL_ITEM_NONE) {
+				if (outType) *outType = type;
+				return n;
+			}
+			// Our own view is still out: nothing comes until we release it.
+			if (s->frontAcquired && !frontHeldElsewhere(s)) return 0;
 		}
-		s->outQ.pop_front();
+
+		std::unique_lock<std::mutex> lk(s->waitMtx);
+		s->readWaiters.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		// While another thread renders or holds a view, wait for it to finish.
+		auto ready = [&]() { return outputReadable(s) || s->readWakeSeq != wakeSeq; };
+		bool woke = true;
+		if (forever) s->outCv.wait(lk, ready);
+		else woke = s->outCv.wait_until(lk, deadline, ready);
+		s->readWaiters.fetch_sub(1, std::memory_order_relaxed);
+
+		if (!woke || s->readWakeSeq != wakeSeq) return 0; // timeout or bl_stop
+		if (!outAudio) return 1;
+		// Otherwise loop and read it; stale items are dropped and we wait again.
 	}
+}
+
+extern "C" BL_API int __cdecl bl_acquireAudio(BL_STATE* s, int* outType, int* outValue, const uint8_t** outData, int* outLen) {
+	if (outType) *outType = BL_ITEM_NONE;
+	if (outValue) *outValue = 0;
+	if (outData) *outData = nullptr;
+	if (outLen) *outLen = 0;
+	if (!s) return 0;
 
-	if (s->outQ.empty()) return 0;
+	std::lock_guard<std::mutex> g(s->readMtx);
+
+	StreamItem* front = readableFrontLocked(s);
+	if (!front) return 0;
+
+	if (outType) *outType = front->type;
+	if (outValue) *outValue = front->value;
+
+	size_t items = 1;
+	if (front->type == BL_ITEM_AUDIO && front->size > front->offset) {
+		size_t remainingSz = front->size - front->offset;
+		// The pool hands blocks out in the order they came back, so an engine
+		// buffer split over several blocks usually sits back to back in one
+		// slab: the blocks that follow on in memory join the view.
+		const uint8_t* end = front->data + front->size;
+		while (StreamItem* next = s->outQ.peek(items)) {
+			if (next->type != BL_ITEM_AUDIO || next->gen != front->gen || next->offset != 0 || next->data != end) break;
+			if (remainingSz + next->size > (size_t)INT_MAX) break;
+			remainingSz += next->size;
+			end += next->size;
+			++items;
+		}
+		if (outData) *outData = front->data + front->offset;
+		if (outLen) *outLen = (int)remainingSz;
+	}
 
-	StreamItem& front = s->outQ.front();
-	if (outType) *outType = front.type;
-	if (outValue) *outValue = front.value;
+	// The slots stay in the ring until bl_releaseAudio; the producer never
+	// writes to published slots, so the view is stable without holding readMtx.
+	s->frontHolder.store(std::this_thread::get_id(), std::memory_order_relaxed);
+	s->frontAcquired = true;
+	s->acquiredItems = items;
+	return 1;
+}
 
-	if (front.type == BL_ITEM_AUDIO) {
-		size_t remainingSz = (front.data.size() > front.offset) ? (front.data.size() - front.offset) : 0;
-		int remaining = (remainingSz > (size_t)INT_MAX) ? INT_MAX : (int)remainingSz;
-		int n = remaining;
-		if (n > outCap) n = outCap;
+extern "C" BL_API void __cdecl bl_releaseAudio(BL_STATE* s) {
+	if (!s) return;
+	std::lock_guard<std::mutex> g(s->readMtx);
+	if (!s->frontAcquired) return;
+	s->frontAcquired = false;
+	for (; s->acquiredItems > 0; --s->acquiredItems) popOutputItemLocked(s);
+	// Readers parked while the view was out.
+	notifyReader(s);
+}
 
-		if (n > 0) {
-			std::memcpy(outAudio, front.data.data() + front.offset, (size_t)n);
-			front.offset += (size_t)n;
+static void __cdecl shmSink(void* user, int type, int value, const uint8_t* pcm, int len);
 
-			if (s->queuedAudioBytes >= (size_t)n) s->queuedAudioBytes -= (size_t)n;
-			else s->queuedAudioBytes = 0;
+// Sink thread: hand each readable item to the registered sink, then park on
+// outCv like bl_readWait until the producers queue more.
+static void sinkLoop(BL_STATE* s) {
+	while (true) {
+		uint32_t wakeSeq;
+		{
+			std::lock_guard<std::mutex> g(s->waitMtx);
+			wakeSeq = s->sinkWakeSeq;
 		}
 
-		if (front.offset >= front.data.size()) {
-			s->outQ.pop_front();
+		while (true) {
+			BL_AUDIO_SINK fn;
+			void* user;
+			{
+				std::unique_lock<std::mutex> lk(s->sinkMtx);
+				s->sinkCv.wait(lk, [&]() { return s->sinkQuit || s->sink; });
+				if (s->sinkQuit) return;
+				fn = s->sink;
+				user = s->sinkUser;
+				s->sinkBusy = true;
+			}
+
+			// The shm epoch goes on the record as it stood before the item was
+			// taken: bl_stop() raises minLiveGen before it bumps the epoch.
+			if (fn == shmSink) static_cast<BlShmWriter*>(user)->stampEpoch();
+
+			int type = BL_ITEM_NONE, value = 0, len = 0;
+			const uint8_t* data = nullptr;
+			const bool got = bl_acquireAudio(s, &type, &value, &data, &len) != 0;
+			if (got) {
+				fn(user, type, value, data, len);
+				bl_releaseAudio(s);
+			}
+
+			{
+				std::lock_guard<std::mutex> g(s->sinkMtx);
+				s->sinkBusy = false;
+			}
+			s->sinkCv.notify_all();
+
+			if (!got) break;
 		}
-		return n;
+
+		// Another reader holding the front (mixing modes) keeps us parked
+		// until its bl_releaseAudio.
+		std::unique_lock<std::mutex> lk(s->waitMtx);
+		s->readWaiters.fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		s->outCv.wait_for(lk, std::chrono::milliseconds(100), [&]() {
+			return outputReadable(s) || s->sinkWakeSeq != wakeSeq;
+		});
+		s->readWaiters.fetch_sub(1, std::memory_order_relaxed);
 	}
+}
 
-	// DONE/ERROR
-	s->outQ.pop_front();
+extern "C" BL_API int __cdecl bl_setAudioSink(BL_STATE* s, BL_AUDIO_SINK sink, void* user) {
+	if (!s) return 1;
+
+	{
+		std::unique_lock<std::mutex> lk(s->sinkMtx);
+		if (s->sinkQuit) return 1;
+		s->sink = sink;
+		s->sinkUser = user;
+		if (sink && !s->sinkThread.joinable()) s->sinkThread = std::thread(sinkLoop, s);
+
+		// Don't return while the old sink may still be running, so the caller can
+		// free `user`. From inside the sink that would deadlock; it's already done.
+		if (std::this_thread::get_id() != s->sinkThread.get_id()) {
+			s->sinkCv.wait(lk, [&]() { return !s->sinkBusy; });
+		}
+	}
+	s->sinkCv.notify_all();
+	wakeSink(s);
 	return 0;
 }
 
+// bl_renderToBufferW gives up when nothing at all comes out for this long.
+// The engine watchdog reports a hang well before that, so this only trips
+// when the stream itself is stuck.
+static const int64_t kRenderIdleUs = 30000000;
+
+extern "C" BL_API int __cdecl bl_renderToBufferW(BL_STATE* s, const wchar_t* text, int noIntonation, uint8_t* buf, int bufCap, uint8_t** outAlloc, int* outBytes) {
+	if (outBytes) *outBytes = 0;
+	if (outAlloc) *outAlloc = nullptr;
+	if (!s) return 1;
+	if (!text || bufCap < 0 || (!buf && !outAlloc)) return 2;
+
+	{
+		std::lock_guard<std::mutex> g(s->sinkMtx);
+		if (s->sink) return 1; // the sink owns the stream
+	}
+	bool idle = false;
+	if (!s->renderMode.compare_exchange_strong(idle, true)) return 1; // one render at a time
+	s->renderOwner.store(std::this_thread::get_id(), std::memory_order_release);
+
+	// Start from a clean stream: whatever was speaking is cut, and its
+	// leftovers are filtered out by gen. Stopping and queueing under cmdMtx,
+	// first in the priority lane and exempt from coalescing, means nothing
+	// anyone else queues can run (or DONE) ahead of it, or drop it.
+	Cmd cmd;
+	cmd.type = Cmd::CMD_SPEAK;
+	cmd.text = text;
+	cmd.noIntonation = (noIntonation != 0);
+	cmd.noCoalesce = true;
+	uint32_t snap;
+	{
+		std::lock_guard<std::mutex> lk(s->cmdMtx);
+		bl_stop(s);
+		snap = s->cancelToken.load(std::memory_order_relaxed);
+		cmd.cancelSnapshot = snap;
+		cmd.enqueuedUs = blNowUs();
+		queueCommandLocked(s, std::move(cmd), BL_SPEAK_PRIORITY);
+	}
+	s->cmdCv.notify_one();
+
+	std::vector<uint8_t> grown;
+	size_t total = 0;
+	int rc = 0;
+	int64_t lastItemUs = blNowUs();
+	while (true) {
+		int type = BL_ITEM_NONE, value = 0, len = 0;
+		const uint8_t* data = nullptr;
+		if (!bl_acquireAudio(s, &type, &value, &data, &len)) {
+			if (s->cancelToken.load(std::memory_order_relaxed) != snap) { rc = 1; break; } // bl_stop from elsewhere
+			if (blNowUs() - lastItemUs > kRenderIdleUs) {
+				bl_stop(s);
+				rc = 5;
+				break;
+			}
+			bl_readWait(s, 100, nullptr, nullptr, nullptr, 0);
+			continue;
+		}
+		lastItemUs = blNowUs();
+
+		if (type == BL_ITEM_AUDIO && len > 0) {
+			if (buf) {
+				if (total < (size_t)bufCap) {
+					const size_t room = (size_t)bufCap - total;
+					std::memcpy(buf + total, data, ((size_t)len < room) ? (size_t)len : room);
+				}
+			} else {
+				grown.insert(grown.end(), data, data + len);
+			}
+			total += (size_t)len;
+		} else if (type == BL_ITEM_ERROR) {
+			rc = 4;
+		}
+		bl_releaseAudio(s);
+		if (type == BL_ITEM_DONE) break;
+	}
+
+	s->renderOwner.store(std::thread::id(), std::memory_order_release);
+	s->renderMode.store(false, std::memory_order_relaxed);
+	// Readers parked in bl_readWait meanwhile can have the stream back.
+	{ std::lock_guard<std::mutex> g(s->waitMtx); }
+	s->outCv.notify_all();
+
+	if (outBytes) *outBytes = (total > (size_t)INT_MAX) ? INT_MAX : (int)total;
+	if (rc == 1 || rc == 5) return rc;
+	if (buf) return (rc == 0 && total > (size_t)bufCap) ? 3 : rc;
+
+	if (!grown.empty()) {
+		uint8_t* p = static_cast<uint8_t*>(std::malloc(grown.size()));
+		if (!p) return 1;
+		std::memcpy(p, grown.data(), grown.size());
+		*outAlloc = p;
+	}
+	return rc;
+}
+
+extern "C" BL_API void __cdecl bl_freeBuffer(uint8_t* p) {
+	std::free(p);
+}
+
+// Sink behind bl_openSharedOutput: republish each item into the shm ring. A
+// full ring parks the sink thread (and through outQ, the engine) until the
+// other process frees room; a stop or a reader gone for 2 s ends the wait.
+static const int64_t kShmReaderGoneUs = 2000000;
+
+static void __cdecl shmSink(void* user, int type, int value, const uint8_t* pcm, int len) {
+	BlShmWriter* w = static_cast<BlShmWriter*>(user);
+	const int64_t giveUpUs = blNowUs() + kShmReaderGoneUs;
+	// A long audio view goes over as several records the ring can hold.
+	uint32_t left = (uint32_t)len;
+	do {
+		const uint32_t n = (left > w->maxPayload()) ? w->maxPayload() : left;
+		while (true) {
+			const uint32_t seen = w->spaceSeq();
+			if (w->write((uint32_t)type, value, pcm, n)) break;
+			if (w->epoch() != w->stamped()) return; // stopped: the reader would skip it anyway
+			const int64_t now = blNowUs();
+			if (now >= giveUpUs) { w->countDrop(); return; }
+			w->waitForSpace(seen, (uint32_t)((giveUpUs - now + 999) / 1000));
+		}
+		pcm += n;
+		left -= n;
+	} while (left > 0);
+}
+
+extern "C" BL_API int __cdecl bl_openSharedOutput(BL_STATE* s, const char* name, int capacityBytes) {
+	if (!s) return 1;
+	if (!name || !*name || capacityBytes < 0) return 2;
+
+	bl_closeSharedOutput(s);
+
+	std::unique_ptr<BlShmWriter> w(new BlShmWriter());
+	if (!w->create(name, (uint32_t)capacityBytes)) return 1;
+	BlShmWriter* out = w.get();
+	{
+		std::lock_guard<std::mutex> g(s->shmMtx);
+		s->shmOut = std::move(w);
+	}
+	return bl_setAudioSink(s, shmSink, out);
+}
+
+extern "C" BL_API void __cdecl bl_closeSharedOutput(BL_STATE* s) {
+	if (!s) return;
+	{
+		std::lock_guard<std::mutex> g(s->shmMtx);
+		if (!s->shmOut) return;
+	}
+	bl_setAudioSink(s, nullptr, nullptr); // returns once shmSink is out of the ring
+
+	std::unique_ptr<BlShmWriter> w;
+	{
+		std::lock_guard<std::mutex> g(s->shmMtx);
+		w = std::move(s->shmOut);
+	}
+}
+
+extern "C" BL_API int __cdecl bl_setOverflowPolicy(BL_STATE* s, int policy) {
+	if (!s) return 1;
+	if (policy != BL_OVERFLOW_BLOCK && policy != BL_OVERFLOW_DROP) return 2;
+	s->overflowPolicy.store(policy, std::memory_order_relaxed);
+	wakeCaptureThread(s); // a parked engine thread re-checks under the new policy
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_setNormalization(BL_STATE* s, int flags) {
+	if (!s) return 1;
+	if (flags & ~BL_NORM_ALL) return 2;
+	s->normalizeFlags.store((unsigned)flags, std::memory_order_relaxed);
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_loadDictionaryW(BL_STATE* s, const wchar_t* path) {
+	if (!s) return 1;
+
+	// Mapped and checked here on the caller's thread; an empty dictionary
+	// stands for "none", so unloading goes through the same handoff.
+	std::unique_ptr<BlDictionary> d(new BlDictionary());
+	if (path && *path && !d->open(path)) return 2;
+
+	// Whatever this displaces was never picked up by the worker, so it's ours.
+	delete s->dictPending.exchange(d.release(), std::memory_order_release);
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_setCoalescing(BL_STATE* s, int mode, int maxDepth) {
+	if (!s) return 1;
+	if (mode != BL_COALESCE_OFF && mode != BL_COALESCE_LATEST && mode != BL_COALESCE_MERGE) return 2;
+	if (maxDepth < 0 || maxDepth > 1024) return 2;
+	std::lock_guard<std::mutex> lk(s->cmdMtx);
+	s->coalesceMode = mode;
+	s->coalesceMaxDepth = maxDepth;
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_getCoalesceStats(BL_STATE* s, uint32_t* dropped, uint32_t* merged) {
+	if (!s) return 0;
+	std::lock_guard<std::mutex> lk(s->cmdMtx);
+	if (dropped) *dropped = s->coalescedDropped;
+	if (merged) *merged = s->coalescedMerged;
+	return 1;
+}
+
+extern "C" BL_API int __cdecl bl_setPacingMode(BL_STATE* s, int mode) {
+	if (!s) return 1;
+	if (mode != BL_PACING_REALTIME && mode != BL_PACING_LOOKAHEAD) return 2;
+	s->pacingMode.store(mode, std::memory_order_relaxed);
+	wakeCaptureThread(s);
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_setLookaheadMs(BL_STATE* s, int burstMs, int lookaheadMs, int maxBufferedMs) {
+	if (!s) return 1;
+
+	// Negative leaves a value as it is.
+	const int burst = (burstMs < 0) ? s->desiredBurstMs.load(std::memory_order_relaxed) : burstMs;
+	const int ahead = (lookaheadMs < 0) ? s->desiredLookaheadMs.load(std::memory_order_relaxed) : lookaheadMs;
+	const int maxMs = (maxBufferedMs < 0) ? s->desiredMaxBufferedMs.load(std::memory_order_relaxed) : maxBufferedMs;
+
+	if (burst > 10000) return 2;
+	if (ahead < 10 || ahead > 60000) return 2;
+	if (maxMs < 1000 || maxMs > 600000 || maxMs < ahead) return 2;
+
+	s->desiredBurstMs.store(burst, std::memory_order_relaxed);
+	s->desiredLookaheadMs.store(ahead, std::memory_order_relaxed);
+	s->desiredMaxBufferedMs.store(maxMs, std::memory_order_relaxed);
+	return 0;
+}
+
+extern "C" BL_API int __cdecl bl_getLookaheadMs(BL_STATE* s, int* burstMs, int* lookaheadMs, int* maxBufferedMs) {
+	if (!s) return 0;
+	if (burstMs) *burstMs = s->desiredBurstMs.load(std::memory_order_relaxed);
+	if (lookaheadMs) *lookaheadMs = s->desiredLookaheadMs.load(std::memory_order_relaxed);
+	if (maxBufferedMs) *maxBufferedMs = s->desiredMaxBufferedMs.load(std::memory_order_relaxed);
+	return 1;
+}
+
+extern "C" BL_API int __cdecl bl_getOverflowStats(BL_STATE* s, uint64_t* droppedBytes, uint32_t* droppedBlocks, uint32_t* blockedWaits) {
+	if (!s) return 0;
+	if (droppedBytes) *droppedBytes = s->droppedBytes.load(std::memory_order_relaxed);
+	if (droppedBlocks) *droppedBlocks = s->droppedBlocks.load(std::memory_order_relaxed);
+	if (blockedWaits) *blockedWaits = s->overflowWaits.load(std::memory_order_relaxed);
+	return 1;
+}
+
+static void fillPercentiles(int32_t* v, int n, BL_PERCENTILES* p) {
+	if (n == 0) {
+		p->p50Us = p->p90Us = p->p99Us = p->maxUs = -1;
+		return;
+	}
+	std::sort(v, v + n);
+	p->p50Us = v[(n - 1) * 50 / 100];
+	p->p90Us = v[(n - 1) * 90 / 100];
+	p->p99Us = v[(n - 1) * 99 / 100];
+	p->maxUs = v[n - 1];
+}
+
+extern "C" BL_API int __cdecl bl_getStopStats(BL_STATE* s, BL_STOP_STATS* out) {
+	if (!s || !out) return 0;
+	std::memset(out, 0, sizeof(*out));
+
+	int32_t engine[BL_STATS_HISTORY];
+	int32_t idle[BL_STATS_HISTORY];
+	int n = 0;
+	{
+		std::lock_guard<std::mutex> g(s->stopStatsMtx);
+		out->stops = s->stopsMeasured;
+		n = (s->stopsMeasured < BL_STATS_HISTORY) ? (int)s->stopsMeasured : BL_STATS_HISTORY;
+		std::memcpy(engine, s->stopEngineUs, sizeof(int32_t) * n);
+		std::memcpy(idle, s->stopIdleUs, sizeof(int32_t) * n);
+	}
+	out->count = (uint32_t)n;
+	fillPercentiles(engine, n, &out->engineStop);
+	fillPercentiles(idle, n, &out->idle);
+	return 1;
+}
+
+extern "C" BL_API int __cdecl bl_getStats(BL_STATE* s, BL_STATS* out) {
+	if (!s || !out) return 0;
+	std::memset(out, 0, sizeof(*out));
+	out->utterances = s->finishedUtterances.load(std::memory_order_relaxed);
+
+	int n = 0;
+	for (UtteranceTimes& u : s->times) {
+		const uint32_t gen = u.gen.load(std::memory_order_acquire);
+		if (gen == 0 || u.at[MARK_DONE].load(std::memory_order_relaxed) == 0) continue; // empty or still running
+
+		const int64_t base = u.at[MARK_ENQUEUE].load(std::memory_order_relaxed);
+		auto rel = [&](int mark) -> int32_t {
+			const int64_t t = u.at[mark].load(std::memory_order_relaxed);
+			if (t == 0) return -1;
+			const int64_t d = t - base;
+			if (d < 0) return 0;
+			return (d > INT_MAX) ? INT_MAX : (int32_t)d;
+		};
+
+		BL_UTTERANCE_TIMES& r = out->recent[n];
+		r.id = gen;
+		r.flags = u.flags.load(std::memory_order_relaxed);
+		r.dequeueUs = rel(MARK_DEQUEUE);
+		r.startSayUs = rel(MARK_START_SAY);
+		r.firstCaptureUs = rel(MARK_FIRST_CAPTURE);
+		r.firstReadUs = rel(MARK_FIRST_READ);
+		r.engineDoneUs = rel(MARK_ENGINE_DONE);
+		r.doneUs = rel(MARK_DONE);
+
+		// Reused by a newer utterance while we copied: skip rather than mix the two.
+		if (u.gen.load(std::memory_order_acquire) != gen) continue;
+		++n;
+	}
+
+	std::sort(out->recent, out->recent + n,
+		[](const BL_UTTERANCE_TIMES& a, const BL_UTTERANCE_TIMES& b) { return a.id < b.id; });
+	out->count = (uint32_t)n;
+
+	int32_t capture[BL_STATS_HISTORY];
+	int32_t read[BL_STATS_HISTORY];
+	int nc = 0, nr = 0;
+	for (int i = 0; i < n; ++i) {
+		if (out->recent[i].firstCaptureUs >= 0) capture[nc++] = out->recent[i].firstCaptureUs;
+		if (out->recent[i].firstReadUs >= 0) read[nr++] = out->recent[i].firstReadUs;
+	}
+	fillPercentiles(capture, nc, &out->firstCapture);
+	fillPercentiles(read, nr, &out->firstRead);
+	return 1;
+}
+
 // Settings API: store desired values; worker applies them.
 extern "C" BL_API int __cdecl bl_getTempo(BL_STATE* s) {
 	if (!s) return 0;
@@ -0,0 +1,33 @@
+// bl_test.h
+//
+// Just enough of a harness for the header tests: CHECK records a failure and
+// carries on, and each test program returns blTestResult() from main() so
+// ctest sees the outcome. Timings are printed for reference only; nothing
+// fails on speed, since the machines running this vary too much.
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+static int g_blTestFailures = 0;
+
+#define CHECK(cond) \
+	do { \
+		if (!(cond)) { \
+			std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+			++g_blTestFailures; \
+		} \
+	} while (0)
+
+inline int blTestResult(const char* name) {
+	if (g_blTestFailures) {
+		std::fprintf(stderr, "%s: %d check(s) failed\n", name, g_blTestFailures);
+		return 1;
+	}
+	std::printf("%s: ok\n", name);
+	return 0;
+}
+
+inline double blTestSeconds(std::chrono::steady_clock::time_point since) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+}
@@ -0,0 +1,179 @@
+// test_backpressure.cpp
+//
+// BL_OVERFLOW_BLOCK against a deliberately slow consumer, on the portable
+// pieces outQ is made of (SpscRing of items, AudioBlockPool blocks). The
+// producer follows enqueueAudioFromHook/waitForQueueRoom: it only pushes an
+// engine buffer when queueHasRoom's test passes (free blocks, free slots,
+// room under the byte limit), and otherwise parks on a condition variable
+// until the reader brings the queue down to the low watermark. Every byte
+// must come out, in order, and the queue must never pass its limit. The
+// same run with the producer dropping instead (BL_OVERFLOW_DROP) is printed
+// for comparison.
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "bl_pool.h"
+#include "bl_test.h"
+
+namespace {
+
+struct Item {
+	uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
+const uint64_t kTotalBytes = 4ull * 1024 * 1024;
+const size_t kLimitBytes = 64 * 1024;  // bufferLimit()
+const size_t kLowBytes = kLimitBytes / 2;  // lowWatermark()
+const size_t kBlocks = 128;
+
+size_t bufferBytes(uint32_t i) { return 300 + (i * 2654435761u) % 6000; }
+uint8_t byteAt(uint64_t pos) { return (uint8_t)(pos * 131 + (pos >> 11)); }
+
+struct Queue {
+	SpscRing<Item> ring{ kBlocks };
+	AudioBlockPool pool{ kBlocks };
+	std::atomic<size_t> queuedBytes{ 0 };
+	size_t maxQueued = 0;  // producer only
+
+	std::mutex drainMtx;
+	std::condition_variable drainCv;
+	std::atomic<int> drainWaiters{ 0 };
+
+	Queue() { pool.grow(kBlocks); }
+
+	// queueHasRoom
+	bool hasRoom(size_t size) {
+		size_t blocks = (size + AudioBlockPool::blockBytes - 1) / AudioBlockPool::blockBytes;
+		if (blocks > pool.blockCount()) blocks = pool.blockCount();
+		if (pool.freeCount() < blocks) return false;
+		if (ring.capacity() - ring.size() < blocks) return false;
+		const size_t queued = queuedBytes.load();
+		return queued + size <= kLimitBytes || queued <= kLowBytes;
+	}
+
+	// waitForQueueRoom, minus the stop checks.
+	void waitForRoom(size_t size) {
+		std::unique_lock<std::mutex> lk(drainMtx);
+		drainWaiters.fetch_add(1);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		while (!(hasRoom(size) && queuedBytes.load() <= kLowBytes)) drainCv.wait_for(lk, std::chrono::milliseconds(100));
+		drainWaiters.fetch_sub(1);
+	}
+
+	void push(const uint8_t* src, size_t size) {
+		while (size > 0) {
+			Item* slot = ring.pushSlot();
+			uint8_t* block = pool.take();
+			const size_t n = (size < AudioBlockPool::blockBytes) ? size : AudioBlockPool::blockBytes;
+			std::memcpy(block, src, n);
+			slot->data = block;
+			slot->size = n;
+			const size_t queued = queuedBytes.fetch_add(n) + n;
+			if (queued > maxQueued) maxQueued = queued;
+			ring.commitPush();
+			src += n;
+			size -= n;
+		}
+	}
+
+	// popOutputItemLocked + releaseQueuedAudio
+	void pop() {
+		Item* it = ring.front();
+		pool.give(it->data);
+		const size_t n = it->size;
+		ring.pop();
+		const size_t left = queuedBytes.fetch_sub(n) - n;
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (drainWaiters.load() == 0 || left > kLowBytes) return;
+		{ std::lock_guard<std::mutex> g(drainMtx); }
+		drainCv.notify_all();
+	}
+};
+
+struct Result {
+	uint64_t produced = 0;
+	uint64_t received = 0;
+	uint64_t dropped = 0;
+	uint64_t mismatches = 0;
+	uint32_t waits = 0;
+	size_t maxQueued = 0;
+};
+
+Result run(bool block) {
+	Queue q;
+	Result res;
+	std::atomic<bool> done{ false };
+
+	// Reader: naps after every block, so it falls far behind a producer running flat out.
+	std::thread reader([&]() {
+		uint64_t pos = 0;
+		while (true) {
+			Item* it = q.ring.front();
+			if (!it) {
+				if (done && q.ring.empty()) break;
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+				continue;
+			}
+			if (block) {
+				for (size_t k = 0; k < it->size; ++k) {
+					if (it->data[k] != byteAt(pos + k)) { ++res.mismatches; break; }
+				}
+			}
+			pos += it->size;
+			q.pop();
+			std::this_thread::sleep_for(std::chrono::microseconds(20));
+		}
+		res.received = pos;
+	});
+
+	std::vector<uint8_t> engine(8192);
+	uint64_t pos = 0;
+	for (uint32_t i = 0; pos < kTotalBytes; ++i) {
+		const size_t size = bufferBytes(i);
+		for (size_t k = 0; k < size; ++k) engine[k] = byteAt(pos + k);
+		pos += size;
+		if (!q.hasRoom(size)) {
+			if (!block) { res.dropped += size; continue; }
+			++res.waits;
+			q.waitForRoom(size);
+		}
+		q.push(engine.data(), size);
+	}
+	res.produced = pos;
+	done = true;
+	reader.join();
+	res.maxQueued = q.maxQueued;
+	return res;
+}
+
+void testSlowConsumer() {
+	const auto start = std::chrono::steady_clock::now();
+	const Result blocked = run(true);
+	const double secs = blTestSeconds(start);
+	CHECK(blocked.received == blocked.produced);
+	CHECK(blocked.mismatches == 0);
+	CHECK(blocked.dropped == 0);
+	CHECK(blocked.waits > 0);
+	CHECK(blocked.maxQueued <= kLimitBytes);
+
+	const Result dropped = run(false);
+	CHECK(dropped.received + dropped.dropped == dropped.produced);
+
+	std::printf("BLOCK: %llu of %llu bytes delivered, producer parked %u times, queue peak %zu, %.2f s\n",
+		(unsigned long long)blocked.received, (unsigned long long)blocked.produced, blocked.waits, blocked.maxQueued, secs);
+	std::printf("DROP:  %llu of %llu bytes delivered, %llu dropped\n",
+		(unsigned long long)dropped.received, (unsigned long long)dropped.produced, (unsigned long long)dropped.dropped);
+}
+
+} // namespace
+
+int main() {
+	testSlowConsumer();
+	return blTestResult("test_backpressure");
+}
@@ -0,0 +1,140 @@
+// test_chunker.cpp
+//
+// blChunkText (bl_chunker.h) over a corpus of Hungarian prose plus edge
+// cases. For every input, the chunks must:
+//   - each fit in the limit;
+//   - put the text back together, with only whitespace lost at the splits;
+//   - only end mid-word when the window held a single word;
+//   - end at a sentence end whenever the window had one in reach;
+//   - never separate a surrogate pair.
+// Chunk counts and sizes are printed next to the drivers' old blind slicing,
+// which needed fewer calls only by cutting words in half.
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bl_chunker.h"
+#include "bl_test.h"
+
+namespace {
+
+const wchar_t* const kWords[] = {
+	L"a", L"az", L"és", L"hogy", L"nem", L"is", L"meg", L"csak", L"már", L"még",
+	L"beszéd", L"szintetizátor", L"képernyőolvasó", L"felhasználó", L"billentyűzet",
+	L"Magyarország", L"legeslegmegszentségteleníthetetlenebbjeitekként", L"önkormányzat",
+	L"NVDA", L"BraiLab", L"2025", L"12,5", L"őszibarack", L"tükörfúrógép", L"árvíztűrő",
+};
+
+const wchar_t kPunct[] = { L'.', L',', L',', L';', L':', L'?', L'!', 0x2026 };
+
+// Prose-like text: words with a mix of clause and sentence punctuation, and
+// the odd run of extra whitespace.
+std::wstring prose(std::mt19937& rng, size_t len) {
+	std::wstring s;
+	while (s.size() < len) {
+		if (!s.empty()) s += (rng() % 20 == 0) ? L"  \r\n" : L" ";
+		s += kWords[rng() % (sizeof(kWords) / sizeof(kWords[0]))];
+		if (rng() % 6 == 0) s += kPunct[rng() % (sizeof(kPunct) / sizeof(kPunct[0]))];
+	}
+	return s;
+}
+
+bool wordEndAt(const std::wstring& text, size_t i) {
+	return i > 0 && i < text.size() && blIsSpaceUnit(text[i]) && !blIsSpaceUnit(text[i - 1]);
+}
+
+size_t g_chunks = 0;
+size_t g_chunkUnits = 0;
+size_t g_blindSlices = 0;
+size_t g_blindMidWord = 0;
+
+void checkChunks(const std::wstring& text, size_t maxChars) {
+	const std::vector<std::wstring> chunks = blChunkText(text, maxChars);
+	g_chunks += chunks.size();
+	for (const std::wstring& chunk : chunks) g_chunkUnits += chunk.size();
+	g_blindSlices += text.empty() ? 1 : (text.size() + maxChars - 1) / maxChars;
+	for (size_t i = maxChars; i < text.size(); i += maxChars) {
+		if (!blIsSpaceUnit(text[i - 1]) && !blIsSpaceUnit(text[i])) ++g_blindMidWord;
+	}
+
+	CHECK(!chunks.empty());
+	if (text.size() <= maxChars) {
+		CHECK(chunks.size() == 1 && chunks[0] == text);
+		return;
+	}
+
+	size_t pos = 0;
+	for (size_t c = 0; c < chunks.size(); ++c) {
+		const std::wstring& chunk = chunks[c];
+		const bool last = c + 1 == chunks.size();
+		CHECK(chunk.size() <= maxChars);
+		CHECK(!chunk.empty());
+		CHECK(text.compare(pos, chunk.size(), chunk) == 0);
+		if (!last) CHECK(!blIsSpaceUnit(chunk.back()));
+
+		const size_t end = pos + chunk.size();
+		if (!last) {
+			// Best break in the window, by the chunker's own ranking.
+			size_t wordEnds = 0;
+			bool sentenceInReach = false;
+			for (size_t i = pos + 1; i <= pos + maxChars && i < text.size(); ++i) {
+				if (!wordEndAt(text, i)) continue;
+				++wordEnds;
+				if (i >= pos + maxChars / 3 && blBreakRank(text[i - 1]) == 4) sentenceInReach = true;
+			}
+			const bool midWord = end < text.size() && !blIsSpaceUnit(text[end]);
+			if (midWord) CHECK(wordEnds == 0);
+			if (sentenceInReach) CHECK(blBreakRank(chunk.back()) == 4);
+			CHECK(!(text[end] >= 0xDC00 && text[end] <= 0xDFFF && end > pos + 1));
+		}
+
+		pos = end;
+		while (pos < text.size() && blIsSpaceUnit(text[pos])) ++pos;
+	}
+	CHECK(pos == text.size());
+}
+
+void testEdgeCases() {
+	checkChunks(L"", kChunkMaxChars);
+	checkChunks(L"Rövid mondat.", kChunkMaxChars);
+	checkChunks(std::wstring(kChunkMaxChars, L'a'), kChunkMaxChars);
+	checkChunks(std::wstring(kChunkMaxChars + 1, L'a'), kChunkMaxChars);
+	checkChunks(std::wstring(kChunkMaxChars * 3 + 7, L'a'), kChunkMaxChars);
+	checkChunks(std::wstring(kChunkMaxChars * 2, L' '), kChunkMaxChars);
+
+	// One giant word between ordinary ones.
+	checkChunks(L"Első szó " + std::wstring(1000, L'x') + L" utolsó szavak.", kChunkMaxChars);
+
+	// A surrogate pair straddling the hard cut.
+	std::wstring pairs;
+	while (pairs.size() < kChunkMaxChars * 2) pairs += L"\xD83D\xDE00";
+	checkChunks(L"x" + pairs, kChunkMaxChars);
+
+	// Sentence end early in the window loses to a clause end in the last two
+	// thirds; a sentence end there wins over a later comma.
+	std::wstring t = L"Egy. " + std::wstring(200, L'b') + L", " + std::wstring(300, L'c');
+	std::vector<std::wstring> chunks = blChunkText(t, kChunkMaxChars);
+	CHECK(chunks.size() == 2 && chunks[0].back() == L',');
+	t = std::wstring(200, L'b') + L". " + std::wstring(100, L'c') + L", " + std::wstring(300, L'd');
+	chunks = blChunkText(t, kChunkMaxChars);
+	CHECK(chunks.size() == 2 && chunks[0].back() == L'.');
+}
+
+void testCorpus() {
+	std::mt19937 rng(450);
+	for (int i = 0; i < 2000; ++i) {
+		const std::wstring text = prose(rng, 50 + rng() % 5000);
+		checkChunks(text, kChunkMaxChars);
+		checkChunks(text, 40 + rng() % 200);
+	}
+}
+
+} // namespace
+
+int main() {
+	testEdgeCases();
+	testCorpus();
+	std::printf("%zu chunks averaging %zu units; blind slicing: %zu slices, %zu cut mid-word\n",
+		g_chunks, g_chunkUnits / g_chunks, g_blindSlices, g_blindMidWord);
+	return blTestResult("test_chunker");
+}
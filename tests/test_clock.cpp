@@ -0,0 +1,115 @@
+// test_clock.cpp
+//
+// BlPacingTimer and blNowUs (bl_clock.h): deadline waits, with and without a
+// cancel handle, never return before their deadline and mostly land within
+// the stated millisecond after it; a signaled cancel cuts a wait short at
+// once. The lateness of every wait goes into a jitter histogram, printed
+// for each kind of wait.
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "bl_clock.h"
+#include "bl_test.h"
+
+namespace {
+
+// Something to cancel a wait with, on either backend.
+#ifdef _WIN32
+struct Cancel {
+	HANDLE event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+	~Cancel() { CloseHandle(event); }
+	void set() { SetEvent(event); }
+	BlCancelHandle handle() { return event; }
+};
+#else
+struct Cancel {
+	BlCancelEvent event;
+	void set() { event.set(); }
+	BlCancelHandle handle() { return &event; }
+};
+#endif
+
+const int kWaits = 400;
+
+void printHistogram(const char* what, std::vector<int64_t> lateUs) {
+	static const int64_t edges[] = { 50, 100, 250, 500, 1000, 2000 };
+	const size_t nEdges = sizeof(edges) / sizeof(edges[0]);
+	size_t counts[nEdges + 1] = {};
+	for (int64_t us : lateUs) {
+		size_t b = 0;
+		while (b < nEdges && us >= edges[b]) ++b;
+		++counts[b];
+	}
+	std::sort(lateUs.begin(), lateUs.end());
+	std::printf("%s: late p50 %lld us, p99 %lld us, max %lld us\n  ", what,
+		(long long)lateUs[lateUs.size() / 2], (long long)lateUs[(lateUs.size() - 1) * 99 / 100], (long long)lateUs.back());
+	int64_t lo = 0;
+	for (size_t b = 0; b < nEdges; ++b) {
+		std::printf("[%lld,%lld) %zu  ", (long long)lo, (long long)edges[b], counts[b]);
+		lo = edges[b];
+	}
+	std::printf(">=%lld %zu\n", (long long)lo, counts[nEdges]);
+}
+
+// Waits of 0.2-3 ms, the size of pacing sleeps between engine buffers.
+void checkDeadlines(const char* what, BlCancelHandle cancel) {
+	BlPacingTimer timer;
+	std::vector<int64_t> lateUs;
+	lateUs.reserve(kWaits);
+	for (int i = 0; i < kWaits; ++i) {
+		const int64_t deadline = blNowUs() + 200 + (i * 7919) % 2800;
+		CHECK(timer.waitUntil(deadline, cancel));
+		lateUs.push_back(blNowUs() - deadline);
+	}
+
+	std::vector<int64_t> sorted = lateUs;
+	std::sort(sorted.begin(), sorted.end());
+	CHECK(sorted.front() >= 0);
+	CHECK(sorted[sorted.size() * 9 / 10] < kBlPacingToleranceUs);
+	printHistogram(what, lateUs);
+}
+
+void testCancel() {
+	BlPacingTimer timer;
+	Cancel cancel;
+
+	// A deadline already past returns at once, true unless cancelled.
+	CHECK(timer.waitUntil(blNowUs() - 1000, cancel.handle()));
+
+	// Signaled from another thread, a long wait ends early and reports it.
+	const int64_t start = blNowUs();
+	std::thread setter([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		cancel.set();
+	});
+	CHECK(!timer.waitUntil(start + 5000000, cancel.handle()));
+	const int64_t tookUs = blNowUs() - start;
+	setter.join();
+	CHECK(tookUs >= 15000 && tookUs < 1000000);
+
+	// Still signaled: even an expired wait says it was cancelled.
+	CHECK(!timer.waitUntil(blNowUs() + 1000, cancel.handle()));
+	CHECK(!timer.waitUntil(blNowUs() - 1000, cancel.handle()));
+}
+
+void testClock() {
+	int64_t last = blNowUs();
+	for (int i = 0; i < 100000; ++i) {
+		const int64_t now = blNowUs();
+		CHECK(now >= last);
+		last = now;
+	}
+}
+
+} // namespace
+
+int main() {
+	testClock();
+	checkDeadlines("timer", nullptr);
+	Cancel unsignaled;
+	checkDeadlines("timer + cancel handle", unsignaled.handle());
+	testCancel();
+	return blTestResult("test_clock");
+}
@@ -0,0 +1,365 @@
+// test_cmdqueue.cpp
+//
+// LaneQueue and resumePoint (bl_cmdqueue.h): lane order, the queue edits the
+// coalescing modes make, and a small model of the worker that preempts a
+// composite utterance at a part boundary and resumes it from its last index
+// marker, the way workerLoop and requeuePreempted use them. Then a stress
+// replay of a keystroke trace (typing echo on the normal lane, arrow-key
+// line reads on the priority lane) through queueCommandLocked's coalescing
+// rules, against a worker on a virtual clock: how many commands each mode
+// lets through, and how long priority commands wait.
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bl_cmdqueue.h"
+#include "bl_test.h"
+
+namespace {
+
+struct Part {
+	bool index = false;
+	int value = 0; // index number, or which text
+};
+
+struct Cmd {
+	std::string name;
+	bool plain = true; // a CMD_SPEAK, which coalescing may drop
+	bool resumeAfter = false;
+	std::vector<Part> parts;
+	int64_t enqueuedUs = 0;
+};
+
+Cmd speak(const char* name) {
+	Cmd c;
+	c.name = name;
+	return c;
+}
+
+std::vector<std::string> drain(LaneQueue<Cmd>& q) {
+	std::vector<std::string> names;
+	Cmd c;
+	while (q.pop(c)) names.push_back(c.name);
+	return names;
+}
+
+void testLaneOrder() {
+	LaneQueue<Cmd> q;
+	CHECK(q.empty());
+	Cmd c;
+	CHECK(!q.pop(c));
+
+	q.push(speak("n1"), LANE_NORMAL);
+	q.push(speak("n2"), LANE_NORMAL);
+	q.push(speak("p1"), LANE_PRIORITY);
+	q.push(speak("x"), 7); // unknown lanes are normal
+	q.push(speak("p2"), LANE_PRIORITY);
+	CHECK(q.size() == 5);
+	CHECK(q.hasPending(LANE_PRIORITY));
+	CHECK(q.peek(LANE_PRIORITY) && q.peek(LANE_PRIORITY)->name == "p1");
+	CHECK(q.back(LANE_NORMAL) && q.back(LANE_NORMAL)->name == "x");
+
+	int lane = -1;
+	CHECK(q.pop(c, &lane) && c.name == "p1" && lane == LANE_PRIORITY);
+	q.pushFront(speak("front"), LANE_NORMAL);
+	CHECK((drain(q) == std::vector<std::string>{ "p2", "front", "n1", "n2", "x" }));
+	CHECK(q.empty());
+}
+
+void testCoalescingEdits() {
+	LaneQueue<Cmd> q;
+	Cmd utt = speak("utt");
+	utt.plain = false;
+	q.push(speak("a"), LANE_NORMAL);
+	q.push(std::move(utt), LANE_NORMAL);
+	q.push(speak("b"), LANE_NORMAL);
+	q.push(speak("c"), LANE_NORMAL);
+	q.push(speak("p"), LANE_PRIORITY);
+
+	auto isPlain = [](const Cmd& c) { return c.plain; };
+
+	// MAX_DEPTH 2: the oldest plain speech goes, composites stay.
+	CHECK(q.trimOldest(LANE_NORMAL, 2, isPlain) == 1);
+	CHECK(q.trimOldest(LANE_NORMAL, 2, isPlain) == 0);
+	// LATEST: every waiting plain speech of the lane goes, the other lane is untouched.
+	CHECK(q.removeIf(LANE_NORMAL, isPlain) == 2);
+	CHECK((drain(q) == std::vector<std::string>{ "p", "utt" }));
+}
+
+// The worker in miniature: speaks one part per step, and between parts of a
+// normal-lane composite gives way to anything in the priority lane,
+// requeueing the rest if that priority command asked to resume it.
+std::vector<std::string> runWorker(LaneQueue<Cmd>& q, std::vector<Cmd> arrivals, size_t arriveAtPart) {
+	std::vector<std::string> spoken;
+	size_t step = 0;
+	Cmd cmd;
+	int lane = LANE_NORMAL;
+	while (q.pop(cmd, &lane)) {
+		if (cmd.parts.empty()) {
+			spoken.push_back(cmd.name);
+			continue;
+		}
+		for (size_t i = 0; i < cmd.parts.size(); ++i) {
+			if (step++ == arriveAtPart) {
+				for (Cmd& a : arrivals) q.push(std::move(a), LANE_PRIORITY);
+				arrivals.clear();
+			}
+			if (i > 0 && lane == LANE_NORMAL && q.hasPending(LANE_PRIORITY)) {
+				const Cmd* next = q.peek(LANE_PRIORITY);
+				if (next->resumeAfter) {
+					const size_t from = resumePoint(cmd.parts, i, [](const Part& p) { return p.index; });
+					Cmd rest;
+					rest.name = cmd.name;
+					rest.plain = false;
+					rest.parts.assign(cmd.parts.begin() + (std::ptrdiff_t)from, cmd.parts.end());
+					q.pushFront(std::move(rest), LANE_NORMAL);
+				}
+				break;
+			}
+			const Part& p = cmd.parts[i];
+			spoken.push_back(p.index ? "#" + std::to_string(p.value) : cmd.name + std::to_string(p.value));
+		}
+	}
+	return spoken;
+}
+
+Cmd sayAll() {
+	Cmd c;
+	c.name = "t";
+	c.plain = false;
+	for (int k = 0; k < 3; ++k) {
+		c.parts.push_back(Part{ true, k });
+		c.parts.push_back(Part{ false, k });
+	}
+	return c; // #0 t0 #1 t1 #2 t2
+}
+
+void testPreemptAndResume() {
+	// Key echo with resume arrives while t1 is about to start: t1's stretch is
+	// spoken again from #1, with the INDEX re-sent.
+	LaneQueue<Cmd> q;
+	q.push(sayAll(), LANE_NORMAL);
+	q.push(speak("later"), LANE_NORMAL);
+	Cmd echo = speak("echo");
+	echo.resumeAfter = true;
+	std::vector<Cmd> arrivals;
+	arrivals.push_back(std::move(echo));
+	CHECK((runWorker(q, std::move(arrivals), 3) ==
+		std::vector<std::string>{ "#0", "t0", "#1", "echo", "#1", "t1", "#2", "t2", "later" }));
+
+	// Without resume the rest of the composite is dropped.
+	q.push(sayAll(), LANE_NORMAL);
+	arrivals.clear();
+	arrivals.push_back(speak("focus"));
+	CHECK((runWorker(q, std::move(arrivals), 2) == std::vector<std::string>{ "#0", "t0", "focus" }));
+
+	// Preempted before any index was reached: resumes from the start.
+	LaneQueue<Cmd> q2;
+	Cmd plainText;
+	plainText.name = "u";
+	plainText.plain = false;
+	plainText.parts = { Part{ false, 0 }, Part{ false, 1 } };
+	q2.push(std::move(plainText), LANE_NORMAL);
+	echo = speak("echo");
+	echo.resumeAfter = true;
+	arrivals.clear();
+	arrivals.push_back(std::move(echo));
+	CHECK((runWorker(q2, std::move(arrivals), 0) == std::vector<std::string>{ "u0", "echo", "u0", "u1" }));
+
+	// A priority composite isn't preempted by the next priority command.
+	Cmd urgent = sayAll();
+	urgent.name = "p";
+	q2.push(std::move(urgent), LANE_PRIORITY);
+	arrivals.clear();
+	arrivals.push_back(speak("echo"));
+	CHECK((runWorker(q2, std::move(arrivals), 1) ==
+		std::vector<std::string>{ "#0", "p0", "#1", "p1", "#2", "p2", "echo" }));
+}
+
+void testResumePoint() {
+	auto isIndex = [](const Part& p) { return p.index; };
+	const std::vector<Part> parts = { Part{ false, 0 }, Part{ true, 1 }, Part{ false, 1 }, Part{ true, 2 }, Part{ false, 2 } };
+	CHECK(resumePoint(parts, 0, isIndex) == 0);
+	CHECK(resumePoint(parts, 1, isIndex) == 0);
+	CHECK(resumePoint(parts, 2, isIndex) == 1);
+	CHECK(resumePoint(parts, 4, isIndex) == 3);
+	CHECK(resumePoint(parts, 99, isIndex) == 3);
+	CHECK(resumePoint(std::vector<Part>{}, 3, isIndex) == 0);
+}
+
+// Same values as BL_COALESCE_*.
+enum { COALESCE_OFF = 0, COALESCE_LATEST = 1, COALESCE_MERGE = 2 };
+
+struct Coalescing {
+	int mode = COALESCE_OFF;
+	size_t maxDepth = 0;
+	size_t dropped = 0;
+	size_t merged = 0;
+};
+
+// queueCommandLocked's rules; the command's name stands in for its text.
+void queueCommand(LaneQueue<Cmd>& q, Cmd cmd, int lane, Coalescing& c) {
+	auto isPlain = [](const Cmd& x) { return x.plain; };
+	if (cmd.plain && c.mode == COALESCE_LATEST) {
+		c.dropped += q.removeIf(lane, isPlain);
+	} else if (cmd.plain && c.mode == COALESCE_MERGE) {
+		Cmd* tail = q.back(lane);
+		if (tail && tail->plain) {
+			tail->name += ' ';
+			tail->name += cmd.name;
+			++c.merged;
+			return;
+		}
+	}
+	q.push(std::move(cmd), lane);
+	if (c.maxDepth > 0) c.dropped += q.trimOldest(lane, c.maxDepth, isPlain);
+}
+
+struct KeyEvent {
+	int64_t atUs;
+	int lane;
+	std::string text;
+};
+
+// Twenty seconds of a fast typist and arrow-key navigation, in the shape of
+// a recorded trace: characters 50-110 ms apart, each echoed, with the word
+// echoed after each space; runs of 10-25 arrow presses 30-60 ms apart, each
+// reading a 20-80 character line on the priority lane.
+std::vector<KeyEvent> keystrokeTrace() {
+	std::mt19937 rng(18);
+	std::vector<KeyEvent> trace;
+	int64_t t = 0;
+	while (t < 20000000) {
+		const int words = 3 + rng() % 6;
+		for (int w = 0; w < words; ++w) {
+			std::string word;
+			const int len = 2 + rng() % 8;
+			for (int k = 0; k < len; ++k) {
+				t += 50000 + rng() % 60000;
+				word += (char)('a' + rng() % 26);
+				trace.push_back(KeyEvent{ t, LANE_NORMAL, word.substr(word.size() - 1) });
+			}
+			t += 50000 + rng() % 60000;
+			trace.push_back(KeyEvent{ t, LANE_NORMAL, word });
+		}
+		const int arrows = 10 + rng() % 16;
+		for (int a = 0; a < arrows; ++a) {
+			t += 30000 + rng() % 30000;
+			trace.push_back(KeyEvent{ t, LANE_PRIORITY, std::string(20 + rng() % 61, 'x') });
+		}
+		t += 300000 + rng() % 700000;
+	}
+	return trace;
+}
+
+// Time the worker spends on a command: starting it plus speaking its text.
+int64_t speakUs(const Cmd& c) { return 100000 + 60000 * (int64_t)c.name.size(); }
+
+struct Replay {
+	size_t issued = 0;
+	size_t spoken = 0;
+	size_t issuedChars = 0;
+	size_t spokenChars = 0; // not counting the spaces MERGE adds
+	std::vector<int64_t> priorityWaitUs;
+	int64_t longestCommandUs = 0;
+	size_t dropped = 0;
+	size_t merged = 0;
+};
+
+// The worker on a virtual clock: it takes the next command whenever it is
+// free, and a command once started runs to its end.
+Replay replay(const std::vector<KeyEvent>& trace, int mode, size_t maxDepth) {
+	LaneQueue<Cmd> q;
+	Coalescing c;
+	c.mode = mode;
+	c.maxDepth = maxDepth;
+	Replay r;
+	int64_t freeAt = 0;
+	size_t next = 0;
+	while (next < trace.size() || !q.empty()) {
+		// Queue everything that arrives before the worker is free.
+		while (next < trace.size() && (trace[next].atUs <= freeAt || q.empty())) {
+			const KeyEvent& e = trace[next++];
+			Cmd cmd = speak(e.text.c_str());
+			cmd.enqueuedUs = e.atUs;
+			++r.issued;
+			r.issuedChars += e.text.size();
+			if (freeAt < e.atUs && q.empty()) freeAt = e.atUs;
+			queueCommand(q, std::move(cmd), e.lane, c);
+		}
+		Cmd cmd;
+		int lane = LANE_NORMAL;
+		if (!q.pop(cmd, &lane)) continue;
+		if (lane == LANE_PRIORITY) r.priorityWaitUs.push_back(freeAt - cmd.enqueuedUs);
+		++r.spoken;
+		r.spokenChars += (size_t)std::count_if(cmd.name.begin(), cmd.name.end(), [](char ch) { return ch != ' '; });
+		const int64_t d = speakUs(cmd);
+		r.longestCommandUs = std::max(r.longestCommandUs, d);
+		freeAt += d;
+	}
+	r.dropped = c.dropped;
+	r.merged = c.merged;
+	std::sort(r.priorityWaitUs.begin(), r.priorityWaitUs.end());
+	return r;
+}
+
+int64_t percentileMs(const std::vector<int64_t>& sorted, int pct) {
+	return sorted.empty() ? 0 : sorted[(sorted.size() - 1) * pct / 100] / 1000;
+}
+
+void printReplay(const char* what, const Replay& r) {
+	std::printf("%-14s %5zu of %zu commands spoken (%.1f%%), priority wait p50 %lld ms, p99 %lld ms\n",
+		what, r.spoken, r.issued, 100.0 * r.spoken / r.issued,
+		(long long)percentileMs(r.priorityWaitUs, 50), (long long)percentileMs(r.priorityWaitUs, 99));
+}
+
+void testKeystrokeStorm() {
+	const std::vector<KeyEvent> trace = keystrokeTrace();
+
+	const Replay off = replay(trace, COALESCE_OFF, 0);
+	const Replay latest = replay(trace, COALESCE_LATEST, 0);
+	const Replay merge = replay(trace, COALESCE_MERGE, 0);
+	const Replay depth = replay(trace, COALESCE_OFF, 2);
+
+	// Without coalescing everything is spoken, and the backlog keeps growing.
+	CHECK(off.spoken == off.issued && off.dropped == 0);
+	// LATEST keeps one waiting command per lane: most of the storm goes, and
+	// a priority command waits for at most the one already speaking.
+	CHECK(latest.spoken + latest.dropped == latest.issued);
+	CHECK(latest.spoken * 4 < latest.issued);
+	CHECK(!latest.priorityWaitUs.empty() && latest.priorityWaitUs.back() <= latest.longestCommandUs);
+	CHECK(percentileMs(latest.priorityWaitUs, 99) * 10 < percentileMs(off.priorityWaitUs, 99));
+	// MERGE loses no text, only command overhead.
+	CHECK(merge.spokenChars == merge.issuedChars);
+	CHECK(merge.spoken + merge.merged == merge.issued && merge.spoken < merge.issued / 2);
+	// A depth limit alone bounds each lane's wait to that many commands.
+	CHECK(depth.spoken + depth.dropped == depth.issued && depth.dropped > 0);
+
+	printReplay("off:", off);
+	printReplay("latest:", latest);
+	printReplay("merge:", merge);
+	printReplay("off, depth 2:", depth);
+
+	// The queue work itself, replayed many times over.
+	const auto start = std::chrono::steady_clock::now();
+	size_t events = 0;
+	for (int i = 0; i < 500; ++i) {
+		events += replay(trace, COALESCE_LATEST, 0).issued;
+		events += replay(trace, COALESCE_MERGE, 0).issued;
+	}
+	const double secs = blTestSeconds(start);
+	std::printf("%zu keystroke commands queued and run in %.3f s (%.0f per second)\n", events, secs, events / secs);
+}
+
+} // namespace
+
+int main() {
+	testLaneOrder();
+	testCoalescingEdits();
+	testResumePoint();
+	testPreemptAndResume();
+	testKeystrokeStorm();
+	return blTestResult("test_cmdqueue");
+}
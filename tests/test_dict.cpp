@@ -0,0 +1,201 @@
+// test_dict.cpp
+//
+// tools/compile_dict.py and BlDictionary (bl_dict.h) end to end: word lists
+// are compiled with the real script, mapped, and applied to text, and the
+// result is compared with a plain longest-match replacement over a std::map.
+// Covers hand-picked cases (case folding, whole words, overlapping and
+// multi-word keys) and a large random list, which also times the compiler.
+//
+// Usage: test_dict <python> <compile_dict.py> <scratch dir>
+#include <cstdlib>
+#include <cwctype>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bl_dict.h"
+#include "bl_test.h"
+
+namespace {
+
+std::string g_python;
+std::string g_compiler;
+std::string g_dir;
+
+std::string utf8(const std::wstring& s) {
+	std::string out;
+	for (wchar_t wc : s) {
+		const uint32_t c = (uint32_t)wc;
+		if (c < 0x80) {
+			out += (char)c;
+		} else if (c < 0x800) {
+			out += (char)(0xC0 | (c >> 6));
+			out += (char)(0x80 | (c & 0x3F));
+		} else {
+			out += (char)(0xE0 | (c >> 12));
+			out += (char)(0x80 | ((c >> 6) & 0x3F));
+			out += (char)(0x80 | (c & 0x3F));
+		}
+	}
+	return out;
+}
+
+std::wstring fold(const std::wstring& s) {
+	std::wstring out;
+	for (wchar_t c : s) out += blToLowerHu(c);
+	return out;
+}
+
+typedef std::map<std::wstring, std::wstring> Entries; // folded key -> replacement
+
+// Writes `entries` as a word list, compiles it, and opens the result.
+bool compile(const Entries& entries, const char* name, BlDictionary& dict) {
+	const std::string txt = g_dir + "/" + name + ".txt";
+	const std::string out = g_dir + "/" + name + ".bldict";
+	{
+		std::ofstream f(txt, std::ios::binary);
+		f << "# generated by test_dict\n\n";
+		for (const auto& e : entries) f << utf8(e.first) << '\t' << utf8(e.second) << '\n';
+	}
+	std::string cmd = "\"" + g_python + "\" \"" + g_compiler + "\" \"" + txt + "\" \"" + out + "\"";
+#ifdef _WIN32
+	cmd = "\"" + cmd + "\""; // cmd.exe strips one pair of outer quotes
+#endif
+	const auto start = std::chrono::steady_clock::now();
+	const int rc = std::system(cmd.c_str());
+	std::printf("compiled %zu entries in %.2f s\n", entries.size(), blTestSeconds(start));
+	CHECK(rc == 0);
+	if (rc != 0) return false;
+	const bool ok = dict.open(std::wstring(out.begin(), out.end()).c_str());
+	CHECK(ok);
+	return ok;
+}
+
+// Reference: at each word start, the longest key that ends on a word boundary.
+std::wstring reference(const Entries& entries, size_t maxKey, const std::wstring& in) {
+	std::wstring out;
+	size_t i = 0;
+	while (i < in.size()) {
+		if (!blIsWordUnit(in[i]) || (i > 0 && blIsWordUnit(in[i - 1]))) {
+			out += in[i++];
+			continue;
+		}
+		size_t len = (in.size() - i < maxKey) ? in.size() - i : maxKey;
+		for (; len > 0; --len) {
+			if (i + len < in.size() && blIsWordUnit(in[i + len])) continue;
+			auto it = entries.find(fold(in.substr(i, len)));
+			if (it != entries.end()) {
+				out += it->second;
+				i += len;
+				break;
+			}
+		}
+		if (len == 0) {
+			do out += in[i++]; while (i < in.size() && blIsWordUnit(in[i]));
+		}
+	}
+	return out;
+}
+
+size_t longestKey(const Entries& entries) {
+	size_t n = 0;
+	for (const auto& e : entries) n = (e.first.size() > n) ? e.first.size() : n;
+	return n;
+}
+
+void expectApply(const BlDictionary& dict, const Entries& entries, const std::wstring& in) {
+	std::wstring got;
+	dict.apply(in.c_str(), in.size(), got);
+	const bool ok = got == reference(entries, longestKey(entries), in);
+	CHECK(ok);
+	if (!ok) std::fprintf(stderr, "  input: %s\n  got:   %s\n", utf8(in).c_str(), utf8(got).c_str());
+}
+
+void testHandPicked() {
+	Entries e;
+	e[L"nvda"] = L"envédéá";
+	e[L"new"] = L"nyú";
+	e[L"new york"] = L"nyújork";
+	e[L"new york city"] = L"nyújork szití";
+	e[L"mp3"] = L"empé három";
+	e[L"árvíztűrő"] = L"árvíz-tűrő";
+	e[L"c"] = L"cé";
+	e[L"x"] = L"";
+
+	BlDictionary dict;
+	if (!compile(e, "handpicked", dict)) return;
+
+	std::wstring out;
+	const std::wstring in = L"Az NVDA és a New York-i New York City, new yorker, NEW. mp3 mp34 c++ cc ÁRVÍZTŰRŐ! x";
+	dict.apply(in.c_str(), in.size(), out);
+	CHECK(out == L"Az envédéá és a nyújork-i nyújork szití, nyú yorker, nyú. empé három mp34 cé++ cc árvíz-tűrő! ");
+	expectApply(dict, e, in);
+	expectApply(dict, e, L"");
+	expectApply(dict, e, L"new");
+	expectApply(dict, e, L"New  York");
+	expectApply(dict, e, L"nvdanvda nvda,nvda");
+}
+
+void testRandom() {
+	static const wchar_t letters[] = L"abcdefghijklmnopqrstuvwxyzáéíóöőúüű0123456789";
+	const size_t nLetters = sizeof(letters) / sizeof(letters[0]) - 1;
+	std::mt19937 rng(25);
+	auto word = [&](size_t minLen, size_t maxLen) {
+		std::wstring w;
+		const size_t len = minLen + rng() % (maxLen - minLen + 1);
+		for (size_t k = 0; k < len; ++k) w += letters[rng() % nLetters];
+		return w;
+	};
+
+	Entries e;
+	std::vector<std::wstring> keys;
+	while (e.size() < 20000) {
+		std::wstring key = word(1, 8);
+		if (rng() % 10 == 0) key += L" " + word(1, 6);
+		e[key] = word(0, 10);
+		keys.push_back(key);
+	}
+
+	BlDictionary dict;
+	if (!compile(e, "random", dict)) return;
+
+	for (const auto& entry : e) {
+		std::wstring out;
+		dict.apply(entry.first.c_str(), entry.first.size(), out);
+		CHECK(out == entry.second);
+	}
+
+	// Text mixing keys (some capitalized), their prefixes and extensions, and
+	// random words, with assorted separators.
+	static const wchar_t* const seps[] = { L" ", L", ", L". ", L"-", L"  ", L"\n" };
+	for (int t = 0; t < 500; ++t) {
+		std::wstring text;
+		for (int w = 0; w < 40; ++w) {
+			std::wstring piece = (rng() % 2) ? keys[rng() % keys.size()] : word(1, 8);
+			if (rng() % 4 == 0) piece += word(1, 2);
+			if (rng() % 4 == 0) piece.resize(piece.size() - 1 - rng() % piece.size() / 2);
+			if (!piece.empty() && rng() % 3 == 0) piece[0] = (wchar_t)std::towupper(piece[0]);
+			text += piece;
+			text += seps[rng() % (sizeof(seps) / sizeof(seps[0]))];
+		}
+		expectApply(dict, e, text);
+	}
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+	if (argc != 4) {
+		std::fprintf(stderr, "usage: test_dict <python> <compile_dict.py> <scratch dir>\n");
+		return 2;
+	}
+	g_python = argv[1];
+	g_compiler = argv[2];
+	g_dir = argv[3];
+
+	testHandPicked();
+	testRandom();
+	return blTestResult("test_dict");
+}
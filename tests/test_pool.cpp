@@ -0,0 +1,158 @@
+// test_pool.cpp
+//
+// AudioBlockPool (bl_pool.h): take/give/grow bookkeeping, then a long
+// synthetic utterance pushed through the pool and an SpscRing the way
+// enqueueAudioFromHook and the reader do it: engine-sized buffers split into
+// blocks on one thread, checked and handed back on another. Global operator
+// new is counted, and once the pool is grown the whole utterance must run
+// without a single heap allocation.
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "bl_pool.h"
+#include "bl_test.h"
+
+static std::atomic<size_t> g_allocs{ 0 };
+
+void* operator new(size_t n) {
+	g_allocs.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(n ? n : 1)) return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Same shape as the wrapper's StreamItem.
+struct Item {
+	uint32_t seq = 0;
+	uint8_t* data = nullptr;
+	size_t size = 0;
+};
+
+// Half an hour of 11025 Hz 16-bit mono, in engine buffers of varying size.
+const uint64_t kUtteranceBytes = 22050ull * 60 * 30;
+const size_t kMaxBlocks = 1024;
+
+size_t bufferBytes(uint32_t i) { return 500 + (i * 2654435761u) % 7000; }
+uint8_t byteAt(uint64_t pos) { return (uint8_t)(pos * 131 + (pos >> 11)); }
+
+void testBookkeeping() {
+	AudioBlockPool pool(8);
+	CHECK(pool.blockCount() == 0);
+	CHECK(pool.take() == nullptr);
+
+	pool.grow(4);
+	CHECK(pool.blockCount() == 4 && pool.freeCount() == 4);
+	std::set<uint8_t*> taken;
+	for (int i = 0; i < 4; ++i) taken.insert(pool.take());
+	CHECK(taken.size() == 4 && !taken.count(nullptr));
+	CHECK(pool.take() == nullptr);
+	CHECK(pool.freeCount() == 0);
+
+	// Blocks come back in the order they were given.
+	uint8_t* first = *taken.begin();
+	for (uint8_t* b : taken) pool.give(b);
+	CHECK(pool.take() == first);
+	pool.give(first);
+
+	pool.grow(2); // grow-only
+	CHECK(pool.blockCount() == 4);
+	pool.grow(100); // capped at the free ring's size
+	CHECK(pool.blockCount() == 8 && pool.freeCount() == 8);
+}
+
+void testSteadyStateAllocations() {
+	AudioBlockPool pool(kMaxBlocks);
+	pool.grow(kMaxBlocks);
+	SpscRing<Item> ring(kMaxBlocks);
+
+	std::atomic<bool> go{ false };
+	std::atomic<bool> producerDone{ false };
+	std::atomic<bool> consumerDone{ false };
+	uint64_t bad = 0;
+	uint64_t received = 0;
+
+	std::thread consumer([&]() {
+		while (!go) std::this_thread::yield();
+		uint64_t pos = 0;
+		while (true) {
+			Item* it = ring.front();
+			if (!it) {
+				if (producerDone && ring.empty()) break;
+				std::this_thread::yield();
+				continue;
+			}
+			for (size_t k = 0; k < it->size; ++k) {
+				if (it->data[k] != byteAt(pos + k)) { ++bad; break; }
+			}
+			pos += it->size;
+			pool.give(it->data);
+			it->data = nullptr;
+			ring.pop();
+		}
+		received = pos;
+		consumerDone = true;
+	});
+
+	// The engine's buffer: reused, as tts.dll reuses its WAVEHDRs.
+	std::vector<uint8_t> engine(8192);
+	std::thread producer([&]() {
+		while (!go) std::this_thread::yield();
+		uint64_t pos = 0;
+		uint32_t seq = 0;
+		for (uint32_t i = 0; pos < kUtteranceBytes; ++i) {
+			const size_t size = bufferBytes(i);
+			for (size_t k = 0; k < size; ++k) engine[k] = byteAt(pos + k);
+			const uint8_t* src = engine.data();
+			size_t left = size;
+			while (left > 0) {
+				Item* slot;
+				while (!(slot = ring.pushSlot())) std::this_thread::yield();
+				uint8_t* block;
+				while (!(block = pool.take())) std::this_thread::yield();
+				const size_t n = (left < AudioBlockPool::blockBytes) ? left : AudioBlockPool::blockBytes;
+				std::memcpy(block, src, n);
+				src += n;
+				left -= n;
+				slot->seq = seq++;
+				slot->data = block;
+				slot->size = n;
+				ring.commitPush();
+			}
+			pos += size;
+		}
+		producerDone = true;
+	});
+
+	const auto start = std::chrono::steady_clock::now();
+	const size_t before = g_allocs.load();
+	go = true;
+	while (!consumerDone) std::this_thread::yield();
+	const size_t during = g_allocs.load() - before;
+	const double secs = blTestSeconds(start);
+	producer.join();
+	consumer.join();
+
+	CHECK(bad == 0);
+	CHECK(received >= kUtteranceBytes);
+	CHECK(during == 0);
+	CHECK(pool.freeCount() == kMaxBlocks);
+	std::printf("%.1f MB in %zu-byte blocks: %zu heap allocations, %.3f s\n",
+		received / 1048576.0, AudioBlockPool::blockBytes, during, secs);
+}
+
+} // namespace
+
+int main() {
+	testBookkeeping();
+	testSteadyStateAllocations();
+	return blTestResult("test_pool");
+}
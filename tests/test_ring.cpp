@@ -0,0 +1,161 @@
+// test_ring.cpp
+//
+// SpscRing (bl_ring.h): capacity, peek and wrap-around, then a producer and a
+// consumer thread hammering it with StreamItem-shaped items, checked for
+// order and content. The same workload through a mutex-guarded std::deque
+// (what outQ used to be) is timed alongside for comparison.
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "bl_ring.h"
+#include "bl_test.h"
+
+namespace {
+
+// Same shape as the wrapper's StreamItem.
+struct Item {
+	int type = 0;
+	int value = 0;
+	uint32_t gen = 0;
+	uint8_t* data = nullptr;
+	size_t size = 0;
+	size_t offset = 0;
+};
+
+const int kItems = 2000000;
+
+void testCapacity() {
+	SpscRing<Item> ring(5);
+	CHECK(ring.capacity() == 8);
+	CHECK(ring.empty());
+	CHECK(ring.front() == nullptr);
+
+	for (int i = 0; i < 8; ++i) {
+		Item* slot = ring.pushSlot();
+		CHECK(slot != nullptr);
+		if (!slot) return;
+		slot->value = i;
+		ring.commitPush();
+	}
+	CHECK(ring.size() == 8);
+	CHECK(ring.pushSlot() == nullptr);
+	CHECK(ring.peek(0) == ring.front());
+	CHECK(ring.peek(7) && ring.peek(7)->value == 7);
+	CHECK(ring.peek(8) == nullptr);
+
+	CHECK(ring.front() && ring.front()->value == 0);
+	ring.pop();
+	CHECK(ring.pushSlot() != nullptr);
+	CHECK(ring.front() && ring.front()->value == 1);
+}
+
+void testWrapAround() {
+	SpscRing<Item> ring(4);
+	int next = 0;
+	int expect = 0;
+	// Uneven push/pop batches walk the indices round the ring many times.
+	for (int round = 0; round < 1000; ++round) {
+		const int pushes = 1 + round % 4;
+		for (int i = 0; i < pushes; ++i) {
+			Item* slot = ring.pushSlot();
+			if (!slot) break;
+			slot->value = next++;
+			ring.commitPush();
+		}
+		const int pops = 1 + (round * 7) % 4;
+		for (int i = 0; i < pops; ++i) {
+			Item* front = ring.front();
+			if (!front) break;
+			CHECK(front->value == expect);
+			++expect;
+			ring.pop();
+		}
+	}
+	while (Item* front = ring.front()) {
+		CHECK(front->value == expect);
+		++expect;
+		ring.pop();
+	}
+	CHECK(expect == next);
+}
+
+// Producer pushes kItems numbered items, the consumer checks each arrives
+// once, in order, with every field intact.
+void testStress() {
+	SpscRing<Item> ring(8192);
+	std::atomic<bool> ok{ true };
+
+	const auto start = std::chrono::steady_clock::now();
+	std::thread consumer([&]() {
+		for (int expect = 0; expect < kItems;) {
+			Item* front = ring.front();
+			if (!front) {
+				std::this_thread::yield();
+				continue;
+			}
+			if (front->value != expect || front->gen != (uint32_t)expect * 3u ||
+				front->size != (size_t)(expect & 2047) || front->type != expect % 4) {
+				ok = false;
+			}
+			ring.pop();
+			++expect;
+		}
+	});
+	for (int i = 0; i < kItems;) {
+		Item* slot = ring.pushSlot();
+		if (!slot) {
+			std::this_thread::yield();
+			continue;
+		}
+		slot->type = i % 4;
+		slot->value = i;
+		slot->gen = (uint32_t)i * 3u;
+		slot->size = (size_t)(i & 2047);
+		ring.commitPush();
+		++i;
+	}
+	consumer.join();
+	const double ringSecs = blTestSeconds(start);
+
+	CHECK(ok);
+	CHECK(ring.empty());
+
+	// The old outQ: every push and every read takes the one mutex.
+	std::mutex mtx;
+	std::deque<Item> deque;
+	const auto dequeStart = std::chrono::steady_clock::now();
+	std::thread dequeConsumer([&]() {
+		for (int expect = 0; expect < kItems;) {
+			std::lock_guard<std::mutex> g(mtx);
+			if (deque.empty()) continue;
+			if (deque.front().value != expect) ok = false;
+			deque.pop_front();
+			++expect;
+		}
+	});
+	for (int i = 0; i < kItems; ++i) {
+		Item item;
+		item.type = i % 4;
+		item.value = i;
+		std::lock_guard<std::mutex> g(mtx);
+		deque.push_back(item);
+	}
+	dequeConsumer.join();
+	const double dequeSecs = blTestSeconds(dequeStart);
+	CHECK(ok);
+
+	std::printf("%d items: ring %.1f ns/item, mutex+deque %.1f ns/item\n", kItems,
+		ringSecs * 1e9 / kItems, dequeSecs * 1e9 / kItems);
+}
+
+} // namespace
+
+int main() {
+	testCapacity();
+	testWrapAround();
+	testStress();
+	return blTestResult("test_ring");
+}
@@ -0,0 +1,273 @@
+// test_sanitize.cpp
+//
+// blSanitizeInto (bl_sanitize.h) against the sanitizer it replaced: the
+// UTF-16 -> CP1250 -> UTF-16 round trip followed by the control/'?'/NBSP
+// cleanup and whitespace collapse. On Windows the reference is that code as
+// it was, WideCharToMultiByte and all; elsewhere iconv's CP1250 stands in for
+// the Windows code page. Either way the reference never touches the
+// generated table, so a wrong table or a wrong fast path shows up here.
+//
+// Checked over every BMP code unit, a mixed Hungarian/Unicode corpus and
+// random text, through both 16-bit units (where the SSE2 path runs) and
+// wchar_t. Throughput of both is printed for reference.
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <iconv.h>
+#endif
+
+#include "bl_sanitize.h"
+#include "bl_test.h"
+
+namespace {
+
+#ifdef _WIN32
+
+// The round trip exactly as sanitizeForBrailab did it.
+std::u16string roundTrip(const std::u16string& text) {
+	const wchar_t* in = reinterpret_cast<const wchar_t*>(text.c_str());
+	BOOL usedDefault = FALSE;
+	int blen = WideCharToMultiByte(1250, WC_NO_BEST_FIT_CHARS, in, -1, nullptr, 0, "?", &usedDefault);
+	if (blen <= 0) return u"";
+	std::string bytes((size_t)blen, '\0');
+	WideCharToMultiByte(1250, WC_NO_BEST_FIT_CHARS, in, -1, &bytes[0], blen, "?", &usedDefault);
+
+	int wlen = MultiByteToWideChar(1250, 0, bytes.c_str(), -1, nullptr, 0);
+	if (wlen <= 0) return u"";
+	std::wstring out((size_t)wlen, L'\0');
+	MultiByteToWideChar(1250, 0, bytes.c_str(), -1, &out[0], wlen);
+	if (!out.empty() && out.back() == L'\0') out.pop_back();
+	return std::u16string(out.begin(), out.end());
+}
+
+#else
+
+// What the round trip gives each BMP code point on its own: itself if CP1250
+// encodes it and decodes back to it, else '?' (the default character).
+class Cp1250RoundTrip {
+public:
+	Cp1250RoundTrip() : units(0x10000, u'?') {
+		iconv_t enc = iconv_open("CP1250", "WCHAR_T");
+		iconv_t dec = iconv_open("WCHAR_T", "CP1250");
+		CHECK(enc != (iconv_t)-1 && dec != (iconv_t)-1);
+		if (enc == (iconv_t)-1 || dec == (iconv_t)-1) return;
+
+		for (uint32_t u = 1; u < 0x10000; ++u) {
+			if (u >= 0xD800 && u <= 0xDFFF) continue;
+			wchar_t wc = (wchar_t)u;
+			char byte[4];
+			char* inp = reinterpret_cast<char*>(&wc);
+			size_t inLeft = sizeof(wc);
+			char* outp = byte;
+			size_t outLeft = sizeof(byte);
+			iconv(enc, nullptr, nullptr, nullptr, nullptr);
+			if (iconv(enc, &inp, &inLeft, &outp, &outLeft) == (size_t)-1 || outp - byte != 1) continue;
+
+			wchar_t back = 0;
+			inp = byte;
+			inLeft = 1;
+			outp = reinterpret_cast<char*>(&back);
+			outLeft = sizeof(back);
+			iconv(dec, nullptr, nullptr, nullptr, nullptr);
+			if (iconv(dec, &inp, &inLeft, &outp, &outLeft) == (size_t)-1) continue;
+			units[u] = (char16_t)back;
+		}
+		iconv_close(enc);
+		iconv_close(dec);
+	}
+
+	// Like WideCharToMultiByte with -1: stops at NUL, and a surrogate pair is
+	// one character, so it becomes one '?'.
+	std::u16string operator()(const std::u16string& text) const {
+		std::u16string out;
+		for (size_t i = 0; i < text.size() && text[i]; ++i) {
+			const char16_t c = text[i];
+			if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size() && text[i + 1] >= 0xDC00 && text[i + 1] <= 0xDFFF) ++i;
+			out.push_back(units[c]);
+		}
+		return out;
+	}
+
+private:
+	std::vector<char16_t> units;
+};
+
+std::u16string roundTrip(const std::u16string& text) {
+	static const Cp1250RoundTrip table;
+	return table(text);
+}
+
+#endif
+
+// The old sanitizer: round trip, then the cleanup passes, verbatim.
+std::u16string oldSanitize(const std::u16string& in) {
+	std::u16string out = roundTrip(in);
+
+	for (auto& ch : out) {
+		if ((ch < 0x20 && ch != u'\r' && ch != u'\n' && ch != u'\t') || (ch >= 0x7F && ch <= 0x9F)) {
+			ch = u' ';
+		}
+		if (ch == 0x00A0) ch = u' ';
+		if (ch == u'?') ch = u' ';
+	}
+
+	std::u16string collapsed;
+	collapsed.reserve(out.size());
+	bool prevSpace = true;
+	for (char16_t ch : out) {
+		const bool isSpace = (ch == u' ' || ch == u'\t' || ch == u'\r' || ch == u'\n');
+		if (isSpace) {
+			if (!prevSpace) collapsed.push_back(u' ');
+			prevSpace = true;
+		} else {
+			collapsed.push_back(ch);
+			prevSpace = false;
+		}
+	}
+	while (!collapsed.empty() && collapsed.back() == u' ') collapsed.pop_back();
+	return collapsed;
+}
+
+// The new pass, as the wrapper calls it (wcslen, then one buffer).
+std::u16string newSanitize(const std::u16string& in) {
+	size_t len = 0;
+	while (len < in.size() && in[len]) ++len;
+	std::u16string out(len, u'\0');
+	out.resize(blSanitizeInto(in.data(), len, &out[0]));
+	return out;
+}
+
+// Same through wchar_t, which is 32 bits outside Windows and skips SSE2.
+std::u16string newSanitizeWide(const std::u16string& in) {
+	std::wstring wide;
+	for (char16_t c : in) {
+		if (!c) break;
+		wide.push_back((wchar_t)c);
+	}
+	std::wstring out(wide.size(), L'\0');
+	out.resize(blSanitizeInto(wide.data(), wide.size(), &out[0]));
+	return std::u16string(out.begin(), out.end());
+}
+
+int g_mismatches = 0;
+
+void expectSame(const std::u16string& text) {
+	const std::u16string want = oldSanitize(text);
+	const bool ok = newSanitize(text) == want && newSanitizeWide(text) == want;
+	CHECK(ok);
+	if (!ok && ++g_mismatches <= 5) {
+		std::fprintf(stderr, "  mismatch on:");
+		for (char16_t c : text) std::fprintf(stderr, " %04X", (unsigned)c);
+		std::fprintf(stderr, "\n");
+	}
+}
+
+void testEveryUnit() {
+	for (uint32_t u = 1; u < 0x10000; ++u) {
+		const char16_t c = (char16_t)u;
+		expectSame(std::u16string(1, c));
+		// Between letters, doubled, and inside a plain ASCII run long enough
+		// for the 8-unit path on either side of it.
+		expectSame(std::u16string(u"a") + c + u"b" + c + c + u" z");
+		expectSame(std::u16string(u"abcdefgh ") + c + u" ijklmnop qrstuvwx");
+	}
+}
+
+const char16_t* const kCorpus[] = {
+	u"",
+	u" ",
+	u"Jó napot kívánok!",
+	u"Árvíztűrő tükörfúrógép. ÁRVÍZTŰRŐ TÜKÖRFÚRÓGÉP.",
+	u"Az NVDA 2025.1-es verziója már támogatja a BraiLab beszédet?",
+	u"Öt szép szűz lány őrült írót nyúz.",
+	u"  leading and   trailing\t\twhitespace \r\n ",
+	u"non breaking spaces  here",
+	u"smart “quotes” and ‘apostrophes’ – dashes — and…",
+	u"euro €, pound £, yen ¥, section §, degree °",
+	u"Ŕőzsa és ŕéz: Czech č ř ž, Polish ą ę ł ń ś ź ż, Slovak ľ ĺ ŕ",
+	u"Cyrillic Привет мир, Greek Καλημέρα, CJK 你好世界",
+	u"emoji \U0001F600 and \U0001F44D\U0001F3FD mixed in",
+	u"lone surrogates \xD800 here \xDC00 and \xDBFF\xDFFF pair",
+	u"controls \x01\x02\x07\x1B\x7F\x80\x9F between",
+	u"question?marks??everywhere???",
+	u"tab\tseparated\tvalues\nand\nnew\nlines",
+	u"ligatures ﬁ ﬂ, fullwidth ＡＢ, combining é",
+	u"1.234.567,89 Ft, 50% kedvezmény, §12 (3) bek.",
+};
+
+void testCorpus() {
+	for (const char16_t* text : kCorpus) expectSame(text);
+	// The old code stopped at the first NUL, as does the wrapper's wcslen.
+	expectSame(std::u16string(u"before\0after", 12));
+}
+
+// Random text over the classes the rules care about, in runs long enough to
+// mix the 8-unit path with the table path at every offset.
+std::u16string randomText(std::mt19937& rng, size_t len) {
+	static const char16_t hungarian[] = u"áéíóöőúüűÁÉÍÓÖŐÚÜŰ";
+	static const char16_t special[] = {
+		u' ', u' ', u'\t', u'\r', u'\n', 0x00A0, u'?', 0x0001, 0x007F, 0x0085,
+		0x20AC, 0x201E, 0x2013, 0x0151, 0x0171, 0x03A9, 0x4E2D, 0xD83D, 0xDE00, 0xFFFD,
+	};
+	std::u16string s;
+	s.reserve(len);
+	while (s.size() < len) {
+		const unsigned r = rng() % 100;
+		if (r < 60) {
+			s.push_back((char16_t)(0x20 + rng() % 0x5F));
+		} else if (r < 75) {
+			s.push_back(hungarian[rng() % (sizeof(hungarian) / sizeof(hungarian[0]) - 1)]);
+		} else if (r < 95) {
+			s.push_back(special[rng() % (sizeof(special) / sizeof(special[0]))]);
+		} else {
+			s.push_back((char16_t)(1 + rng() % 0xFFFF));
+		}
+	}
+	return s;
+}
+
+void testRandom() {
+	std::mt19937 rng(1250);
+	for (int i = 0; i < 20000; ++i) expectSame(randomText(rng, rng() % 200));
+}
+
+void benchmark() {
+	std::mt19937 rng(7);
+	std::u16string text;
+	while (text.size() < (1u << 20)) {
+		text += kCorpus[2 + rng() % 6];
+		text += u' ';
+		text += randomText(rng, 64);
+		text += u' ';
+	}
+	const int rounds = 20;
+	const double mb = (double)text.size() * 2 * rounds / (1024.0 * 1024.0);
+
+	size_t sink = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; ++i) sink += newSanitize(text).size();
+	const double newSecs = blTestSeconds(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < rounds; ++i) sink += oldSanitize(text).size();
+	const double oldSecs = blTestSeconds(start);
+
+	std::printf("%.0f MiB of UTF-16: single pass %.0f MiB/s, round trip + cleanup %.0f MiB/s (%zu)\n",
+		mb, mb / newSecs, mb / oldSecs, sink);
+}
+
+} // namespace
+
+int main() {
+	testEveryUnit();
+	testCorpus();
+	testRandom();
+	benchmark();
+	return blTestResult("test_sanitize");
+}
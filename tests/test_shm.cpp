@@ -0,0 +1,235 @@
+// test_shm.cpp
+//
+// BlShmWriter/BlShmReader (bl_shm.h) through a real named region, the reader
+// always on a mapping of its own: a writer and a reader thread streaming
+// audio-shaped records through a small ring (full and empty, so both ends
+// park on their signal, and records wrap past the end with pads), the same
+// stream into a forked reader process on POSIX, taking over a name a dead
+// writer left behind, the epoch invalidation a stop does (including for a
+// record stamped before it), and the waits themselves: they time out when
+// nothing happens and return promptly when the other end moves.
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+#include "bl_shm.h"
+#include "bl_test.h"
+
+namespace {
+
+// Same values as BL_ITEM_AUDIO / BL_ITEM_INDEX.
+const uint32_t kAudio = 1;
+const uint32_t kIndex = 4;
+
+const int kRecords = 20000;
+
+std::string ringName(const char* what) {
+#ifdef _WIN32
+	const unsigned long pid = GetCurrentProcessId();
+#else
+	const unsigned long pid = (unsigned long)getpid();
+#endif
+	return std::string("bl_test_shm_") + what + "_" + std::to_string(pid);
+}
+
+// Record i of the stream: mostly audio of varying length (some long enough
+// to force a pad at the end of the 64 KB ring), every 50th an index marker.
+uint32_t typeOf(int i) { return (i % 50 == 49) ? kIndex : kAudio; }
+uint32_t lenOf(int i) { return (typeOf(i) == kAudio) ? 1 + (uint32_t)(i * 37) % 6000 : 0; }
+uint8_t byteOf(int i, uint32_t k) { return (uint8_t)(i * 7 + k); }
+
+void writeStream(BlShmWriter& w) {
+	std::vector<uint8_t> payload;
+	for (int i = 0; i < kRecords; ++i) {
+		payload.resize(lenOf(i));
+		for (uint32_t k = 0; k < payload.size(); ++k) payload[k] = byteOf(i, k);
+		while (true) {
+			const uint32_t seen = w.spaceSeq();
+			if (w.write(typeOf(i), i, payload.data(), (uint32_t)payload.size())) break;
+			w.waitForSpace(seen, 1000);
+		}
+	}
+}
+
+// Reads the whole stream, checking each record; returns the number of bad ones.
+int readStream(BlShmReader& r) {
+	int bad = 0;
+	for (int i = 0; i < kRecords;) {
+		const uint32_t seen = r.dataSeq();
+		const uint8_t* payload = nullptr;
+		const BlShmRecord* rec = r.front(&payload);
+		if (!rec) {
+			r.waitForData(seen, 1000);
+			continue;
+		}
+		bool ok = rec->type == typeOf(i) && rec->value == i && rec->len == lenOf(i);
+		for (uint32_t k = 0; ok && k < rec->len; ++k) ok = payload[k] == byteOf(i, k);
+		if (!ok) ++bad;
+		r.pop();
+		++i;
+	}
+	return bad;
+}
+
+void testThreads() {
+	const std::string name = ringName("threads");
+	BlShmWriter w;
+	CHECK(w.create(name.c_str(), 0));
+	BlShmReader r;
+	CHECK(r.open(name.c_str()));
+
+	int bad = -1;
+	const auto start = std::chrono::steady_clock::now();
+	std::thread reader([&]() { bad = readStream(r); });
+	writeStream(w);
+	reader.join();
+	CHECK(bad == 0);
+	std::printf("%d records through a 64 KB ring in %.3f s\n", kRecords, blTestSeconds(start));
+}
+
+#ifndef _WIN32
+// The same stream into another process, which is what the ring is for.
+void testFork() {
+	const std::string name = ringName("fork");
+	BlShmWriter w;
+	CHECK(w.create(name.c_str(), 0));
+
+	const pid_t child = fork();
+	CHECK(child >= 0);
+	if (child < 0) return;
+	if (child == 0) {
+		BlShmReader r;
+		if (!r.open(name.c_str())) _exit(2);
+		_exit(readStream(r) == 0 ? 0 : 1);
+	}
+
+	writeStream(w);
+	int status = 0;
+	CHECK(waitpid(child, &status, 0) == child);
+	CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+// A writer that crashed leaves its name behind; the next one takes it over.
+void testStaleName() {
+	const std::string name = ringName("stale");
+	const int fd = shm_open(("/" + name).c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	CHECK(fd >= 0);
+	if (fd >= 0) close(fd);
+
+	BlShmWriter w;
+	CHECK(w.create(name.c_str(), 0));
+	BlShmReader r;
+	CHECK(r.open(name.c_str()));
+	CHECK(w.write(kIndex, 7, nullptr, 0));
+	const BlShmRecord* rec = r.front(nullptr);
+	CHECK(rec && rec->value == 7);
+}
+#endif
+
+void testInvalidate() {
+	const std::string name = ringName("epoch");
+	BlShmWriter w;
+	CHECK(w.create(name.c_str(), 0));
+	BlShmReader r;
+	CHECK(r.open(name.c_str()));
+
+	const uint8_t pcm[4] = { 1, 2, 3, 4 };
+	for (int i = 0; i < 10; ++i) CHECK(w.write(kAudio, i, pcm, sizeof(pcm)));
+	w.invalidate();
+	w.stampEpoch();
+	for (int i = 10; i < 15; ++i) CHECK(w.write(kIndex, i, nullptr, 0));
+
+	// Everything from before the stop is skipped, in O(1) on the writer's side.
+	for (int i = 10; i < 15; ++i) {
+		const BlShmRecord* rec = r.front(nullptr);
+		CHECK(rec && rec->value == i && rec->type == kIndex);
+		if (rec) r.pop();
+	}
+	CHECK(r.front(nullptr) == nullptr);
+
+	// Stamped before a stop, written after it: from before the stop, so skipped.
+	w.stampEpoch();
+	w.invalidate();
+	CHECK(w.epoch() != w.stamped());
+	CHECK(w.write(kAudio, 20, pcm, sizeof(pcm)));
+	w.stampEpoch();
+	CHECK(w.write(kIndex, 21, nullptr, 0));
+	const BlShmRecord* rec = r.front(nullptr);
+	CHECK(rec && rec->value == 21);
+}
+
+void testWaits() {
+	const std::string name = ringName("waits");
+	BlShmWriter w;
+	CHECK(w.create(name.c_str(), 0));
+	BlShmReader r;
+	CHECK(r.open(name.c_str()));
+
+	// Nothing written: the reader's wait runs out.
+	auto start = std::chrono::steady_clock::now();
+	r.waitForData(r.dataSeq(), 50);
+	CHECK(blTestSeconds(start) >= 0.04);
+
+	// A write wakes it long before its timeout.
+	uint32_t seen = r.dataSeq();
+	start = std::chrono::steady_clock::now();
+	std::thread writer([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		w.write(kIndex, 1, nullptr, 0);
+	});
+	r.waitForData(seen, 5000);
+	const double readerWoke = blTestSeconds(start);
+	writer.join();
+	CHECK(readerWoke < 2.0);
+	CHECK(r.front(nullptr) != nullptr);
+	r.pop();
+
+	// Fill the ring, then a pop wakes the writer.
+	std::vector<uint8_t> block(4096, 0);
+	while (w.write(kAudio, 0, block.data(), (uint32_t)block.size())) {}
+	seen = w.spaceSeq();
+	CHECK(!w.write(kAudio, 0, block.data(), (uint32_t)block.size()));
+	start = std::chrono::steady_clock::now();
+	std::thread reader([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		if (r.front(nullptr)) r.pop();
+	});
+	w.waitForSpace(seen, 5000);
+	const double writerWoke = blTestSeconds(start);
+	reader.join();
+	CHECK(writerWoke < 2.0);
+
+	// A stop wakes a writer waiting for room, too.
+	while (w.write(kAudio, 0, block.data(), (uint32_t)block.size())) {}
+	seen = w.spaceSeq();
+	start = std::chrono::steady_clock::now();
+	std::thread stopper([&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		w.invalidate();
+	});
+	w.waitForSpace(seen, 5000);
+	const double stopWoke = blTestSeconds(start);
+	stopper.join();
+	CHECK(stopWoke < 2.0);
+}
+
+} // namespace
+
+int main() {
+	testThreads();
+#ifndef _WIN32
+	testFork();
+	testStaleName();
+#endif
+	testInvalidate();
+	testWaits();
+	return blTestResult("test_shm");
+}
@@ -0,0 +1,145 @@
+// test_watchdog.cpp
+//
+// BlSpeechRate and BlEngineWatch (bl_watchdog.h) on a fake clock: deadlines
+// from text length and the learned rate, then the worker's wait loop polling
+// a scripted engine every 50 ms the way waitForEngine does. An engine that
+// hangs outright is caught as a stall after kStallUs; one that keeps writing
+// but never finishes runs into its deadline; one parked in our hooks by a
+// slow reader is left alone; a recycled engine speaks the next chunk.
+#include <cstdint>
+#include <vector>
+
+#include "bl_watchdog.h"
+#include "bl_test.h"
+
+namespace {
+
+const int64_t kPollUs = 50000;
+const uint64_t kBytesPerSec = 22050; // 11025 Hz 16-bit mono
+
+// What the engine does at each moment of a chunk, on the fake clock.
+struct ScriptedEngine {
+	int64_t headerEveryUs = 100000;  // 0 = never writes a header
+	int64_t doneAtUs = -1;           // -1 = never calls done
+	int64_t hookFromUs = -1;         // parked in our hook over [hookFromUs, hookToUs)
+	int64_t hookToUs = -1;
+	bool recycled = false;
+
+	uint32_t headersAt(int64_t t) const { return headerEveryUs ? (uint32_t)(t / headerEveryUs) : 0; }
+	bool inHookAt(int64_t t) const { return t >= hookFromUs && t < hookToUs; }
+	bool doneAt(int64_t t) const { return doneAtUs >= 0 && t >= doneAtUs; }
+};
+
+enum Outcome { FINISHED, TIMEOUT, STALLED };
+
+struct Run {
+	Outcome outcome;
+	int64_t atUs;
+};
+
+// waitForEngine against the script, plus what the worker does on a verdict.
+Run speakChunk(ScriptedEngine& engine, const BlSpeechRate& rate, size_t chars, int tempo) {
+	int64_t now = 0;
+	BlEngineWatch watch(rate.budgetUs(chars, tempo), now, engine.headersAt(now));
+	while (true) {
+		now += kPollUs;
+		if (engine.doneAt(now)) return Run{ FINISHED, now };
+		const BlEngineVerdict v = watch.poll(now, engine.headersAt(now), engine.inHookAt(now));
+		if (v == BL_ENGINE_RUNNING) continue;
+		engine.recycled = true;
+		return Run{ (v == BL_ENGINE_TIMEOUT) ? TIMEOUT : STALLED, now };
+	}
+}
+
+void testBudget() {
+	BlSpeechRate rate;
+	// Nothing learned: 200 ms a character, times three, plus slack, clamped.
+	CHECK(rate.usPerChar(50) == kDefaultUsPerChar);
+	CHECK(rate.budgetUs(2, 50) == kWatchdogMinUs);
+	CHECK(rate.budgetUs(10, 50) == 3 * 10 * 200000 + kWatchdogSlackUs);
+	CHECK(rate.budgetUs(100000, 50) == kWatchdogMaxUs);
+
+	// 100 characters in 5 s of audio: 50 ms a character.
+	rate.learn(100, 5 * kBytesPerSec, kBytesPerSec, 50);
+	CHECK(rate.usPerChar(50) == 50000);
+	CHECK(rate.budgetUs(100, 50) == 3 * 100 * 50000 + kWatchdogSlackUs);
+
+	// Later chunks move it a quarter of the way each.
+	rate.learn(100, 9 * kBytesPerSec, kBytesPerSec, 50); // 90 ms a character
+	CHECK(rate.usPerChar(50) == 60000);
+
+	// Too short to count, or nothing to go on.
+	rate.learn(kRateMinChars - 1, 60 * kBytesPerSec, kBytesPerSec, 50);
+	rate.learn(100, 0, kBytesPerSec, 50);
+	rate.learn(100, kBytesPerSec, 0, 50);
+	CHECK(rate.usPerChar(50) == 60000);
+
+	// Another tempo: the default until a chunk at that tempo finishes.
+	CHECK(rate.usPerChar(80) == kDefaultUsPerChar);
+	rate.learn(100, 3 * kBytesPerSec, kBytesPerSec, 80);
+	CHECK(rate.usPerChar(80) == 30000);
+	CHECK(rate.usPerChar(50) == kDefaultUsPerChar);
+}
+
+void testHungEngine() {
+	BlSpeechRate rate;
+	rate.learn(100, 5 * kBytesPerSec, kBytesPerSec, 50);
+
+	// Two words, then nothing at all: a stall, after kStallUs rather than the
+	// 180 s the fixed timeout used to give it.
+	ScriptedEngine hung;
+	hung.headerEveryUs = 0;
+	const Run r = speakChunk(hung, rate, 10, 50);
+	CHECK(r.outcome == STALLED);
+	CHECK(r.atUs > kStallUs && r.atUs <= kStallUs + 2 * kPollUs);
+	CHECK(hung.recycled);
+
+	// The recycled engine speaks the next chunk normally.
+	ScriptedEngine fresh;
+	fresh.doneAtUs = 1500000;
+	const Run next = speakChunk(fresh, rate, 30, 50);
+	CHECK(next.outcome == FINISHED && !fresh.recycled);
+}
+
+void testRunawayEngine() {
+	BlSpeechRate rate;
+	rate.learn(100, 5 * kBytesPerSec, kBytesPerSec, 50);
+
+	// Keeps writing headers but never finishes: the deadline for 40 characters
+	// at 50 ms each is 3 x 2 s + 5 s.
+	ScriptedEngine loop;
+	const Run r = speakChunk(loop, rate, 40, 50);
+	CHECK(r.outcome == TIMEOUT);
+	CHECK(r.atUs > rate.budgetUs(40, 50) && r.atUs <= rate.budgetUs(40, 50) + 2 * kPollUs);
+	CHECK(loop.recycled);
+}
+
+void testParkedEngine() {
+	BlSpeechRate rate;
+	rate.learn(100, 5 * kBytesPerSec, kBytesPerSec, 50);
+
+	// A slow reader holds the engine in our hook for a minute: neither the
+	// deadline (11 s) nor the stall check may fire; the chunk then finishes.
+	ScriptedEngine parked;
+	parked.headerEveryUs = 0;
+	parked.hookFromUs = 1000000;
+	parked.hookToUs = 61000000;
+	parked.doneAtUs = 62000000;
+	const Run r = speakChunk(parked, rate, 40, 50);
+	CHECK(r.outcome == FINISHED && !parked.recycled);
+
+	// Slow but steady speech finishes well inside its deadline.
+	ScriptedEngine slow;
+	slow.doneAtUs = rate.budgetUs(40, 50) - 1000000;
+	CHECK(speakChunk(slow, rate, 40, 50).outcome == FINISHED);
+}
+
+} // namespace
+
+int main() {
+	testBudget();
+	testHungEngine();
+	testRunawayEngine();
+	testParkedEngine();
+	return blTestResult("test_watchdog");
+}
@@ -0,0 +1,210 @@
+# -*- coding: utf-8 -*-
+r"""Compile a pronunciation list into the dictionary file bl_loadDictionaryW maps.
+
+    python tools\compile_dict.py words.txt words.bldict
+
+Input is UTF-8 text, one entry per line:
+
+    NVDA<TAB>envédéá
+    New York<TAB>nyújork
+
+The key is everything before the first tab, the replacement everything after
+it. Blank lines and lines starting with '#' are skipped. Keys match whole
+words regardless of case; they must start with a letter or digit and stay
+within Latin (up to U+024F). A key listed twice keeps its last replacement.
+
+Updating a dictionary that is in use
+------------------------------------
+The wrapper keeps the file mapped, and on Windows a mapped file can't be
+overwritten: this script would fail to open it. Compile to a new name and
+load that with bl_loadDictionaryW instead; the old file is unmapped once the
+next utterance starts and can then be deleted.
+
+Output layout
+-------------
+The format is described in src/bl_dict.h. Keys are case-folded through the
+alphabet table, so each folded character gets one transition code, and the
+trie goes into a double array (base/check): the child of node n on code c is
+node base[n] + c, which is real if check[base[n] + c] == n. Lookups are then
+one array step per character, whatever the size of the list.
+"""
+import struct
+import sys
+from collections import deque
+
+MAGIC = 0x54444C42  # "BLDT"
+VERSION = 1
+ALPHABET_UNITS = 0x250  # Basic Latin through Latin Extended-B
+HEADER_BYTES = 64
+TRY_LIMIT = 8  # failed placements before a free slot stops being a start point
+
+
+def is_word_unit(ch):
+    """Same classes as blIsWordUnit in src/bl_normalize.h."""
+    u = ord(ch)
+    if ch.isascii():
+        return ch.isalnum()
+    return 0xC0 <= u < ALPHABET_UNITS and u not in (0xD7, 0xF7)
+
+
+def fold(ch):
+    """The character `ch` matches as: its lower case if that is one unit in range."""
+    low = ch.lower()
+    if len(low) == 1 and ord(low) < ALPHABET_UNITS:
+        return low
+    return ch
+
+
+def read_entries(path):
+    entries = {}
+    with open(path, encoding='utf-8-sig') as f:
+        for lineno, line in enumerate(f, 1):
+            line = line.rstrip('\r\n')
+            if not line.strip() or line.startswith('#'):
+                continue
+            if '\t' not in line:
+                sys.exit('%s:%d: expected key<TAB>replacement' % (path, lineno))
+            key, repl = line.split('\t', 1)
+            key = key.strip()
+            if not key or not is_word_unit(key[0]):
+                sys.exit('%s:%d: key must start with a letter or digit' % (path, lineno))
+            if any(ord(ch) >= ALPHABET_UNITS for ch in key):
+                sys.exit('%s:%d: key has characters past U+%04X' % (path, lineno, ALPHABET_UNITS - 1))
+            if any(ord(ch) > 0xFFFF for ch in repl):
+                sys.exit('%s:%d: replacement has characters past the BMP' % (path, lineno))
+            folded = ''.join(fold(ch) for ch in key)
+            if folded in entries:
+                print('%s:%d: "%s" listed again, keeping this one' % (path, lineno, key))
+            entries[folded] = repl
+    return entries
+
+
+def build_alphabet(keys):
+    """Code unit -> transition code (1-based), shared by both cases."""
+    chars = sorted({ch for key in keys for ch in key})
+    codes = {ch: i + 1 for i, ch in enumerate(chars)}
+    alphabet = [0] * ALPHABET_UNITS
+    for u in range(ALPHABET_UNITS):
+        alphabet[u] = codes.get(fold(chr(u)), 0)
+    return alphabet, codes
+
+
+def build_double_array(entries, codes):
+    # Plain trie first: node = (children {code: node}, value index or -1).
+    children = [{}]
+    value = [-1]
+    for v, key in enumerate(sorted(entries)):
+        n = 0
+        for ch in key:
+            c = codes[ch]
+            if c not in children[n]:
+                children[n][c] = len(children)
+                children.append({})
+                value.append(-1)
+            n = children[n][c]
+        value[n] = v
+
+    # Place nodes breadth first, each node's children at the first base that
+    # has all of their slots free. Slot 0 is the root. `used` marks taken
+    # slots, and bytearray.find jumps to the next free one, so candidate bases
+    # only ever come from free slots. A free slot that has failed as a
+    # candidate TRY_LIMIT times is stepped over from then on (`search_from`),
+    # so nodes with many children don't retry the same packed region.
+    max_code = len(codes)
+    base = [0]
+    check = [-1]
+    dvalue = [-1]
+    used = bytearray(b'\x01')
+    tries = bytearray(1)
+    slot = {0: 0}  # trie node -> double-array index
+    search_from = 1
+    queue = deque([0])
+    while queue:
+        node = queue.popleft()
+        kids = sorted(children[node].items())
+        if not kids:
+            continue
+        first = kids[0][0]
+        pos = search_from
+        while True:
+            pos = used.find(0, pos)
+            if pos < 0 or pos + max_code >= len(used):
+                # Room for the highest child code past any candidate.
+                end = len(used)
+                used.extend(bytes(end + max_code + 1))
+                tries.extend(bytes(end + max_code + 1))
+                if pos < 0:
+                    pos = end
+            b = pos - first
+            if b >= 1 and all(not used[b + c] for c, _ in kids):
+                break
+            if tries[pos] < TRY_LIMIT:
+                tries[pos] += 1
+            pos += 1
+        top = b + kids[-1][0]
+        if top >= len(check):
+            grow = top + 1 - len(check)
+            base += [0] * grow
+            check += [-1] * grow
+            dvalue += [-1] * grow
+        here = slot[node]
+        base[here] = b
+        for c, kid in kids:
+            t = b + c
+            used[t] = 1
+            check[t] = here
+            slot[kid] = t
+            dvalue[t] = value[kid]
+            queue.append(kid)
+        search_from = used.find(0, search_from)
+        while search_from >= 0 and tries[search_from] >= TRY_LIMIT:
+            search_from = used.find(0, search_from + 1)
+        if search_from < 0:
+            search_from = len(used)
+    dvalue[0] = value[0]
+    return base, check, dvalue
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit('usage: ' + __doc__.strip().splitlines()[2].strip())
+    src, dst = sys.argv[1], sys.argv[2]
+
+    entries = read_entries(src)
+    keys = sorted(entries)
+    alphabet, codes = build_alphabet(keys)
+    base, check, value = build_double_array(entries, codes)
+
+    text = []
+    text_index = [0]
+    for key in keys:
+        units = entries[key].encode('utf-16-le')
+        text += struct.unpack('<%dH' % (len(units) // 2), units)
+        text_index.append(len(text))
+
+    # Sections in file order, each aligned for its element size.
+    sections = [
+        ('H', alphabet),
+        ('i', base),
+        ('i', check),
+        ('i', value),
+        ('I', text_index),
+        ('H', text),
+    ]
+    body = b''
+    offsets = []
+    for fmt, items in sections:
+        size = struct.calcsize(fmt)
+        body += b'\0' * ((-(HEADER_BYTES + len(body))) % size)
+        offsets.append(HEADER_BYTES + len(body))
+        body += struct.pack('<%d%s' % (len(items), fmt), *items)
+
+    header = struct.pack('<16I', MAGIC, VERSION, ALPHABET_UNITS, len(base), len(keys), len(text),
+                         *(offsets + [0] * 4))
+    with open(dst, 'wb') as f:
+        f.write(header + body)
+    print('wrote %s (%d entries, %d nodes, %d bytes)' % (dst, len(keys), len(base), HEADER_BYTES + len(body)))
+
+
+if __name__ == '__main__':
+    main()
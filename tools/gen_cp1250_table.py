@@ -0,0 +1,98 @@
+# -*- coding: utf-8 -*-
+r"""Generate src/bl_cp1250_table.h, the sanitizer's UTF-16 lookup table.
+
+    python tools\gen_cp1250_table.py
+
+Any Python 3 will do; the output is checked in, so the DLL build itself
+never needs Python. Rerun only if the sanitizer's rules change.
+
+What the table encodes
+----------------------
+sanitizeForBrailab used to round-trip the text through code page 1250
+(WideCharToMultiByte with WC_NO_BEST_FIT_CHARS and "?" as the default, then
+MultiByteToWideChar), and afterwards turn controls, C1 controls, NBSP and
+'?' into spaces. Per UTF-16 code unit that comes down to:
+
+    the unit itself  if CP1250 has it exactly and none of the rules hit it,
+    a space          otherwise (surrogates included).
+
+Spaces are then collapsed, which the table leaves to the C++ loop. Python's
+cp1250 codec is the unicode.org mapping, which is what Windows uses without
+best fit; the five bytes it leaves undefined (0x81 0x83 0x88 0x90 0x98) are
+C1 controls on Windows and end up as spaces either way.
+
+Layout: a 256-entry page index on the high byte, then 256-unit pages. Page 0
+is all spaces, so any high byte without a page of its own lands there.
+"""
+import os
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+ROOT = os.path.dirname(HERE)
+OUT = os.path.join(ROOT, 'src', 'bl_cp1250_table.h')
+
+SPACE = 0x20
+
+
+def safe_unit(u):
+    """What the old round trip plus cleanup made of code unit `u`."""
+    if 0xD800 <= u <= 0xDFFF:
+        return SPACE
+    ch = chr(u)
+    try:
+        back = ch.encode('cp1250').decode('cp1250')
+    except UnicodeError:
+        return SPACE
+    if back != ch:
+        return SPACE
+    if u < 0x20 or 0x7F <= u <= 0x9F or u == 0xA0 or ch == '?':
+        return SPACE
+    return u
+
+
+def main():
+    units = [safe_unit(u) for u in range(0x10000)]
+
+    # Page 0 = blank; then one page per high byte that has anything to keep.
+    pages = [[SPACE] * 256]
+    index = [0] * 256
+    for hi in range(256):
+        page = units[hi * 256:(hi + 1) * 256]
+        if any(v != SPACE for v in page):
+            index[hi] = len(pages)
+            pages.append(page)
+
+    lines = [
+        '// bl_cp1250_table.h',
+        '//',
+        '// GENERATED by tools/gen_cp1250_table.py -- do not edit.',
+        '//',
+        '// UTF-16 code unit -> what Brailab gets for it: the unit itself if code',
+        '// page 1250 has it exactly and it isn\'t a control, NBSP or \'?\', else a',
+        '// space. Look up with kCp1250Pages[kCp1250PageIndex[u >> 8]][u & 0xFF].',
+        '#pragma once',
+        '',
+        '#include <cstdint>',
+        '',
+        'static const uint8_t kCp1250PageIndex[256] = {',
+    ]
+    for row in range(0, 256, 16):
+        lines.append('\t' + ', '.join('%d' % v for v in index[row:row + 16]) + ',')
+    lines.append('};')
+    lines.append('')
+    lines.append('static const uint16_t kCp1250Pages[%d][256] = {' % len(pages))
+    for p, page in enumerate(pages):
+        hi = index.index(p) if p else 0
+        lines.append('\t{ // %s' % ('blank' if p == 0 else 'U+%02X00' % hi))
+        for row in range(0, 256, 8):
+            lines.append('\t\t' + ', '.join('0x%04X' % v for v in page[row:row + 8]) + ',')
+        lines.append('\t},')
+    lines.append('};')
+    lines.append('')
+
+    with open(OUT, 'w', newline='\n') as f:
+        f.write('\n'.join(lines))
+    print('wrote %s (%d pages)' % (OUT, len(pages)))
+
+
+if __name__ == '__main__':
+    main()